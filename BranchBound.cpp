@@ -0,0 +1,242 @@
+#include "BranchBound.hpp"
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <functional>
+
+//
+//
+//  Class SCPbranchbound
+//
+//
+
+// コンストラクタ
+SCPbranchbound::SCPbranchbound(SCPbitinstance &binst, int K)
+  : K(K), Incumbent(0), Nodes(0), Optimal(false), binst(binst), nextI(0), nextJ(1), Incomplete(false)
+{
+}
+
+
+// 解 cs を暫定解にする
+void SCPbranchbound::set_incumbent(const SCPsolution &cs)
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  if (cs.num_Cover <= Incumbent.load()) return;
+  BestCols.clear();
+  for (int c : cs.CS)
+  {
+    if (c < binst.numColumns) BestCols.push_back(c);
+  }
+  Incumbent.store(cs.num_Cover);
+}
+
+
+// 暫定解を更新する
+void SCPbranchbound::update(const std::vector<int> &path, int d, int cover)
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  if (cover <= Incumbent.load()) return;
+  BestCols.assign(path.begin(), path.begin() + d);
+  Incumbent.store(cover);
+}
+
+
+// 節点の候補の gain を計算して大きい順に並べる（gain が 0 の列は除く）
+void SCPbranchbound::sort_candidates(Level &lv)
+{
+  lv.items.clear();
+  for (int c : lv.cand)
+  {
+    int g;
+    binst.popcount_andnot(binst.column(c), lv.covered.data(), binst.nWords, 1, &g);
+    if (g > 0) lv.items.push_back(std::make_pair(g, c));
+  }
+  std::sort(lv.items.begin(), lv.items.end(), std::greater<std::pair<int, int>>());
+  lv.prefix.resize(lv.items.size() + 1);
+  lv.prefix[0] = 0;
+  for (size_t i = 0; i < lv.items.size(); i++) lv.prefix[i + 1] = lv.prefix[i] + lv.items[i].first;
+}
+
+
+// d 列を選んだ節点から下を探索する．打ち切られて調べ残した子があれば false
+// levels[d] の covered と cand は親が作っておく
+bool SCPbranchbound::dfs(Worker &w, int d, int cover, SearchControl &ctl)
+{
+  if ((++w.nodes & 1023) == 0 && ctl.should_stop()) return false;
+
+  Level &lv = w.levels[d];
+  sort_candidates(lv);
+  int m = lv.items.size();
+  int r = K - d;                // 残りの列の数
+  int uncovered = binst.numRows - cover;
+
+  // 候補がない・最後の1列：一番 gain の大きい列を選ぶ
+  if (m == 0 || r == 1)
+  {
+    if (m > 0)
+    {
+      w.path[d] = lv.items[0].second;
+      update(w.path, d + 1, cover + lv.items[0].first);
+    }
+    else update(w.path, d, cover);
+    return true;
+  }
+
+  for (int i = 0; i < m; i++)
+  {
+    // i 番目を選ぶ子の上界（i が増えると小さくなるので，刈ったら後は全て刈れる）
+    int top = lv.prefix[std::min(m, i + r)] - lv.prefix[i];
+    if (cover + std::min(uncovered, top) <= Incumbent.load(std::memory_order_relaxed)) break;
+    if (ctl.Stopped.load(std::memory_order_relaxed)) return false;
+
+    int c = lv.items[i].second;
+    Level &child = w.levels[d + 1];
+    const Word *col = binst.column(c);
+    for (int k = 0; k < binst.nWords; k++) child.covered[k] = lv.covered[k] | col[k];
+    child.cand.clear();
+    for (int l = i + 1; l < m; l++) child.cand.push_back(lv.items[l].second);
+    w.path[d] = c;
+    if (!dfs(w, d + 1, cover + lv.items[i].first, ctl)) return false;
+  }
+  return true;
+}
+
+
+// 次の部分木を取る
+// 部分木 (i, j) の上界も j について単調に減るので，刈れたら次の i に進む
+bool SCPbranchbound::next_subtree(int &i, int &j)
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  int m = Root.size();
+  int r = K - 2;
+  while (nextI < m - 1)
+  {
+    int inc = Incumbent.load();
+    int gi = Root[nextI].first;
+    if (gi + RootPrefix[std::min(m, nextI + 1 + K - 1)] - RootPrefix[nextI + 1] <= inc)
+    {
+      nextI = m;                // i が増えても上界は増えない
+      break;
+    }
+    if (nextJ < m &&
+        gi + RootPrefix[std::min(m, nextJ + r + 1)] - RootPrefix[nextJ] > inc)
+    {
+      i = nextI;
+      j = nextJ++;
+      return true;
+    }
+    nextI++;
+    nextJ = nextI + 1;
+  }
+  return false;
+}
+
+
+// スレッドの本体：部分木を取っては探索する
+// 取った部分木を最後まで調べずに打ち切ったら Incomplete にする
+void SCPbranchbound::worker(SearchControl &ctl)
+{
+  Worker w;
+  w.levels.resize(K + 1);
+  for (Level &lv : w.levels) lv.covered.resize(binst.nWords);
+  w.path.resize(K);
+  w.nodes = 0;
+
+  int m = Root.size();
+  int i, j;
+  while (next_subtree(i, j))
+  {
+    if (ctl.should_stop())
+    {
+      Incomplete = true;
+      break;
+    }
+    const Word *ci = binst.column(Root[i].second);
+    const Word *cj = binst.column(Root[j].second);
+    Level &lv = w.levels[2];
+    int cover = Root[i].first;
+    for (int k = 0; k < binst.nWords; k++) lv.covered[k] = ci[k] | cj[k];
+    int g;
+    binst.popcount_andnot(cj, ci, binst.nWords, 1, &g);
+    cover += g;
+    lv.cand.clear();
+    for (int l = j + 1; l < m; l++) lv.cand.push_back(Root[l].second);
+    w.path[0] = Root[i].second;
+    w.path[1] = Root[j].second;
+    w.nodes++;
+    if (K == 2) update(w.path, 2, cover);
+    else if (!dfs(w, 2, cover, ctl))
+    {
+      Incomplete = true;
+      break;
+    }
+  }
+  Nodes.fetch_add(w.nodes);
+}
+
+
+// 解く
+bool SCPbranchbound::solve(int nthreads, SearchControl &ctl)
+{
+  // 根：全ての列の gain（= 列の大きさ）
+  Level root;
+  root.covered.assign(binst.nWords, 0);
+  root.cand.resize(binst.numColumns);
+  for (int j = 0; j < binst.numColumns; j++) root.cand[j] = j;
+  sort_candidates(root);
+  Root.swap(root.items);
+  RootPrefix.swap(root.prefix);
+  Nodes = 1;
+
+  // K < 2 か列が K 列以下なら，根で決まる
+  int m = Root.size();
+  if (K < 2 || m <= K)
+  {
+    std::vector<int> path;
+    int cover = 0;
+    std::vector<Word> covered(binst.nWords, 0);
+    for (int i = 0; i < std::min(K, m); i++)
+    {
+      path.push_back(Root[i].second);
+      const Word *col = binst.column(Root[i].second);
+      for (int k = 0; k < binst.nWords; k++) covered[k] |= col[k];
+    }
+    for (Word x : covered) cover += __builtin_popcountll(x);
+    update(path, path.size(), cover);
+    Optimal = true;
+    return true;
+  }
+
+  nextI = 0;
+  nextJ = 1;
+  Incomplete = false;
+  std::vector<std::thread> pool;
+  for (int t = 1; t < nthreads; t++) pool.emplace_back(&SCPbranchbound::worker, this, std::ref(ctl));
+  worker(ctl);
+  for (std::thread &th : pool) th.join();
+
+  // 全ての部分木を調べ終えたか，暫定解が上界（UpperBound）に達していれば最適
+  Optimal = !Incomplete.load() || Incumbent.load() >= ctl.UpperBound.load();
+  return Optimal;
+}
+
+
+// 暫定解を out に入れる
+void SCPbranchbound::to_solution(SCPinstance &inst, SCPsolution &out) const
+{
+  out.initialize(inst);
+  int n = 0;
+  for (int c : BestCols)
+  {
+    out.add_column(inst, c);
+    n++;
+  }
+  for (int j = 0; j < inst.numColumns && n < K; j++)
+  {
+    if (out.SOLUTION[j] == 0)
+    {
+      out.add_column(inst, j);
+      n++;
+    }
+  }
+}
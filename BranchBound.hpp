@@ -0,0 +1,89 @@
+//---------------------------------------------------------------------------
+// 分枝限定法による最大 k 被覆問題の厳密解法（小・中規模のインスタンス向け）
+// カバーした行はビット集合（SCPbitinstance）で持つ
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SCPv.hpp"
+#include "SCPbitset.hpp"
+#include "SearchControl.hpp"
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+//
+//
+//  Class SCPbranchbound
+//
+//  深さ優先で列を1列ずつ選ぶ．各節点では，残りの候補の列を gain（新たにカバーする行の数）
+//  の大きい順に並べ，i 番目の列を選ぶ子では i+1 番目以降の列だけを候補にする
+//  （同じ列集合を2回数えない）．残り r 列を選ぶ節点の上界は
+//    カバー数 + min(カバーされていない行の数, 大きい方から r 個の gain の和)
+//  で（gain は列を足すと減るだけなので），暫定解のカバー数以下なら枝を刈る．
+//  暫定解は GRASP の解などで初めに与えておく（set_incumbent）．
+//
+//  複数のスレッドで解くときは，根で gain の順に並べた列の組 (i, j)（i < j）を部分木として，
+//  空いたスレッドが共有のカーソルから次の部分木を取る．暫定解は全てのスレッドで共有する．
+//
+class SCPbranchbound
+{
+ public:
+  int K;
+  std::atomic<int> Incumbent;   // 暫定解のカバー数
+  std::vector<int> BestCols;    // 暫定解の列
+  std::atomic<long> Nodes;      // 調べた節点の数
+  bool Optimal;                 // 最適値が求まったか（最後まで探索したか，暫定解が上界に達した）
+
+ public:
+  SCPbranchbound(SCPbitinstance &binst, int K);
+
+  // 解 cs を暫定解にする（cs のカバー数が暫定解より大きいとき）
+  void set_incumbent(const SCPsolution &cs);
+
+  // nthreads 個のスレッドで解く．ctl が打ち切られたら止める．最適値が求まったら true
+  bool solve(int nthreads, SearchControl &ctl);
+
+  // 暫定解を out に入れる（K 列に足りなければカバー数の変わらない列を足す）
+  void to_solution(SCPinstance &inst, SCPsolution &out) const;
+
+ private:
+  // 深さごとの作業領域
+  struct Level
+  {
+    std::vector<Word> covered;  // この節点でカバーされている行
+    std::vector<int> cand;      // 候補の列
+    std::vector<std::pair<int, int>> items; // (gain, 列) を gain の大きい順に
+    std::vector<int> prefix;    // prefix[i]: items の最初の i 個の gain の和
+  };
+
+  // スレッドごとの作業領域
+  struct Worker
+  {
+    std::vector<Level> levels;  // levels[d]: d 列を選んだ節点
+    std::vector<int> path;      // 選んだ列
+    long nodes;
+  };
+
+  SCPbitinstance &binst;
+  std::mutex Mutex;             // BestCols と部分木のカーソル
+  std::vector<std::pair<int, int>> Root; // 根の (gain, 列)，gain の大きい順
+  std::vector<int> RootPrefix;
+  int nextI, nextJ;             // 次に配る部分木 (Root[nextI], Root[nextJ])
+  std::atomic<bool> Incomplete; // 取った部分木を調べ残したスレッドがある
+
+  // 節点の候補の gain を計算して並べる
+  void sort_candidates(Level &lv);
+
+  // 暫定解を更新する
+  void update(const std::vector<int> &path, int d, int cover);
+
+  // 次の部分木を取る（もうなければ false）
+  bool next_subtree(int &i, int &j);
+
+  // d 列を選んだ節点（カバー数 cover）から下を探索する．打ち切られたら false
+  bool dfs(Worker &w, int d, int cover, SearchControl &ctl);
+
+  // スレッドの本体
+  void worker(SearchControl &ctl);
+};
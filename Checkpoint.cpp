@@ -0,0 +1,172 @@
+#include "Checkpoint.hpp"
+#include "SCPv.hpp"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+static const char CHECKPOINT_MAGIC[8] = {'R', 'N', 'K', 'C', 'C', 'K', 'P', 'T'};
+
+// 書き出し・読み込みの補助（読めなければ DataException）
+static void put(FILE *fp, const void *p, size_t n) { fwrite(p, 1, n, fp); }
+static void get(FILE *fp, void *p, size_t n) { if (fread(p, 1, n, fp) != n) throw DataException(); }
+
+static void put_int(FILE *fp, int64_t x) { put(fp, &x, sizeof(x)); }
+static int64_t get_int(FILE *fp) { int64_t x; get(fp, &x, sizeof(x)); return x; }
+
+static void put_ints(FILE *fp, const std::vector<int> &v)
+{
+  put_int(fp, v.size());
+  if (!v.empty()) put(fp, v.data(), v.size() * sizeof(int));
+}
+static void get_ints(FILE *fp, std::vector<int> &v)
+{
+  int64_t n = get_int(fp);
+  if (n < 0 || n > (1 << 30)) throw DataException();
+  v.resize(n);
+  if (n > 0) get(fp, v.data(), n * sizeof(int));
+}
+
+static void put_lists(FILE *fp, const std::vector<std::vector<int>> &v)
+{
+  put_int(fp, v.size());
+  for (const std::vector<int> &x : v) put_ints(fp, x);
+}
+static void get_lists(FILE *fp, std::vector<std::vector<int>> &v)
+{
+  int64_t n = get_int(fp);
+  if (n < 0 || n > (1 << 30)) throw DataException();
+  v.resize(n);
+  for (std::vector<int> &x : v) get_ints(fp, x);
+}
+
+
+//
+//
+//  Class SCPcheckpoint
+//
+//
+
+// コンストラクタ
+SCPcheckpoint::SCPcheckpoint(const std::string &file, double interval,
+                             const std::vector<uint64_t> &settings, int nthreads)
+  : FileName(file), Interval(interval), Settings(settings), ElapsedMs(0), Threads(nthreads)
+{
+  SearchControl::Clock::time_point now = SearchControl::Clock::now();
+  SearchControl::Clock::duration d = std::chrono::duration_cast<SearchControl::Clock::duration>(
+    std::chrono::duration<double, std::milli>(Interval));
+  NextUpdate.assign(nthreads, now + d);
+  NextWrite = now + d;
+}
+
+
+// ファイルから読む
+bool SCPcheckpoint::load()
+{
+  FILE *fp = fopen(FileName.c_str(), "rb");
+  if (fp == NULL) return false;
+  try
+  {
+    char magic[8];
+    get(fp, magic, sizeof(magic));
+    if (memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) throw DataException();
+
+    int64_t n = get_int(fp);
+    if (n != (int64_t)Settings.size()) throw DataException();
+    for (int64_t i = 0; i < n; i++)
+    {
+      uint64_t x;
+      get(fp, &x, sizeof(x));
+      if (x != Settings[i]) throw DataException();
+    }
+    get(fp, &ElapsedMs, sizeof(ElapsedMs));
+    if (get_int(fp) != (int64_t)Threads.size()) throw DataException();
+
+    for (ThreadCheckpoint &s : Threads)
+    {
+      s.restart = get_int(fp);
+      s.iter = get_int(fp);
+      s.iterations = get_int(fp);
+      int64_t len = get_int(fp);
+      if (len < 0 || len > (1 << 20)) throw DataException();
+      s.rng.resize(len);
+      if (len > 0) get(fp, &s.rng[0], len);
+      get_ints(fp, s.best);
+      get_lists(fp, s.poolCols);
+      get_ints(fp, s.poolCover);
+      get_lists(fp, s.done);
+      if (s.poolCols.size() != s.poolCover.size() || (int)s.done.size() != s.restart)
+        throw DataException();
+    }
+  }
+  catch (DataException&)
+  {
+    fclose(fp);
+    throw;
+  }
+  fclose(fp);
+  return true;
+}
+
+
+// スレッド t の状態を s にする
+void SCPcheckpoint::update(int t, const ThreadCheckpoint &s, SearchControl &ctl)
+{
+  SearchControl::Clock::time_point now = SearchControl::Clock::now();
+  SearchControl::Clock::duration d = std::chrono::duration_cast<SearchControl::Clock::duration>(
+    std::chrono::duration<double, std::milli>(Interval));
+  bool writeNow;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    Threads[t] = s;
+    NextUpdate[t] = now + d;
+    writeNow = (now >= NextWrite);
+  }
+  if (writeNow) write(ctl);
+}
+
+
+// 全てのスレッドの状態をファイルに書く
+// FileName.tmp に書いて fsync してから FileName に rename する
+void SCPcheckpoint::write(SearchControl &ctl)
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  std::string tmp = FileName + ".tmp";
+  FILE *fp = fopen(tmp.c_str(), "wb");
+  if (fp == NULL)
+  {
+    printf("Cannot write checkpoint: %s\n", tmp.c_str());
+    return;
+  }
+
+  double elapsed = ElapsedMs + ctl.elapsed_ms();
+  put(fp, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+  put_int(fp, Settings.size());
+  put(fp, Settings.data(), Settings.size() * sizeof(uint64_t));
+  put(fp, &elapsed, sizeof(elapsed));
+  put_int(fp, Threads.size());
+  for (const ThreadCheckpoint &s : Threads)
+  {
+    put_int(fp, s.restart);
+    put_int(fp, s.iter);
+    put_int(fp, s.iterations);
+    put_int(fp, s.rng.size());
+    put(fp, s.rng.data(), s.rng.size());
+    put_ints(fp, s.best);
+    put_lists(fp, s.poolCols);
+    put_ints(fp, s.poolCover);
+    put_lists(fp, s.done);
+  }
+
+  bool ok = (fflush(fp) == 0 && fsync(fileno(fp)) == 0);
+  ok = (fclose(fp) == 0) && ok;
+  if (!ok || rename(tmp.c_str(), FileName.c_str()) != 0)
+  {
+    printf("Cannot write checkpoint: %s\n", FileName.c_str());
+    return;
+  }
+  NextWrite = SearchControl::Clock::now() + std::chrono::duration_cast<SearchControl::Clock::duration>(
+    std::chrono::duration<double, std::milli>(Interval));
+}
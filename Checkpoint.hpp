@@ -0,0 +1,74 @@
+//---------------------------------------------------------------------------
+// 長い探索の途中の状態をファイルに保存し，止まったところから再開する
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SearchControl.hpp"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+// スレッドごとの途中の状態
+// 列番号は，終わった再スタートの解（done）は元のインスタンスの番号，
+// 今の再スタートの最良解とエリート解（best, poolCols）は探索で使うインスタンスの番号
+struct ThreadCheckpoint
+{
+  int restart;                  // 今の再スタート（これより前の再スタートは終わっている）
+  int iter;                     // 今の再スタートで終わった反復の数
+  long iterations;              // このスレッドが終えた反復の数（全ての再スタートの合計）
+  std::string rng;              // 乱数生成器の状態（operator<< の形式．空なら保存していない）
+  std::vector<int> best;        // 今の再スタートの最良解の列
+  std::vector<std::vector<int>> poolCols; // 今の再スタートのエリート解の列
+  std::vector<int> poolCover;
+  std::vector<std::vector<int>> done;     // done[i]: 終わった再スタート i の最良解の列
+
+  ThreadCheckpoint() : restart(0), iter(0), iterations(0) {}
+};
+
+
+//
+//
+//  Class SCPcheckpoint
+//
+//  スレッドは反復の切れ目で due(t) を見て，Interval ミリ秒たっていれば状態を update で渡す．
+//  update は全てのスレッドの最新の状態をファイルに書く．書くときは FileName.tmp に書いてから
+//  rename するので，途中で止まってもファイルは前の状態か新しい状態のどちらかになる．
+//  Settings（乱数の種・K・スレッド数などの実行の設定）が違うファイルからは再開しない．
+//
+//  ファイルの形式（バイナリ）：
+//    "RNKCCKPT", 設定の数, 設定 × (uint64), 経過時間 (double), スレッド数,
+//    スレッドごとに restart, iter, iterations, rng, best, poolCols/poolCover, done
+//  （可変長の部分は要素の数を先に書く）
+//
+class SCPcheckpoint
+{
+ public:
+  std::string FileName;
+  double Interval;              // 書く間隔（ミリ秒）
+  std::vector<uint64_t> Settings;
+  double ElapsedMs;             // 再開する前までの経過時間（時間制限から引く）
+  std::vector<ThreadCheckpoint> Threads;
+
+ public:
+  SCPcheckpoint(const std::string &file, double interval,
+                const std::vector<uint64_t> &settings, int nthreads);
+
+  // ファイルから読む．ファイルがなければ false．設定が違う・壊れていれば DataException
+  bool load();
+
+  // スレッド t が状態を保存する時刻か（steady_clock を1回読むだけ）
+  bool due(int t) const { return SearchControl::Clock::now() >= NextUpdate[t]; }
+
+  // スレッド t の状態を s にして，前に書いてから Interval たっていればファイルに書く
+  void update(int t, const ThreadCheckpoint &s, SearchControl &ctl);
+
+  // 全てのスレッドの状態をファイルに書く（経過時間は再開する前の分も足す）
+  void write(SearchControl &ctl);
+
+ private:
+  std::mutex Mutex;
+  std::vector<SearchControl::Clock::time_point> NextUpdate; // スレッドごとに次に update する時刻
+  SearchControl::Clock::time_point NextWrite;
+};
@@ -0,0 +1,87 @@
+#include "ElitePool.hpp"
+#include <vector>
+#include <cstdint>
+#include <climits>
+
+//
+//
+//  Class ElitePoolT
+//
+//
+
+// コンストラクタ
+template <typename Index>
+ElitePoolT<Index>::ElitePoolT(int maxSize, int K, int minDistance)
+  : maxSize(maxSize), minDistance(minDistance), size(0)
+{
+  Cols.resize(maxSize, std::vector<Index>(K));
+  Cover.resize(maxSize, 0);
+}
+
+
+// 昇順の列リスト a と b の距離（対称差の大きさ）
+template <typename Index>
+int ElitePoolT<Index>::distance(const std::vector<Index>& a, const std::vector<Index>& b)
+{
+  int i = 0, j = 0, common = 0;
+  int na = a.size(), nb = b.size();
+  while (i < na && j < nb)
+  {
+    if (a[i] < b[j]) i++;
+    else if (b[j] < a[i]) j++;
+    else { common++; i++; j++; }
+  }
+  return na + nb - 2 * common;
+}
+
+
+// 昇順の列リスト cols を入れられれば入れる
+template <typename Index>
+bool ElitePoolT<Index>::add(const std::vector<Index>& cols, int cover)
+{
+  if (maxSize == 0) return false;
+
+  int bestCover = INT_MIN;
+  int nearDist = INT_MAX;       // 全ての解との距離の最小値
+  int replace = -1;             // 入れ替える解（cover より小さい解のうち一番近いもの）
+  int replaceDist = INT_MAX;
+  for (int i = 0; i < size; i++)
+  {
+    int d = distance(cols, Cols[i]);
+    if (d == 0) return false;   // 同じ解がある
+    if (bestCover < Cover[i]) bestCover = Cover[i];
+    if (d < nearDist) nearDist = d;
+    if (Cover[i] < cover &&
+        (d < replaceDist || (d == replaceDist && Cover[i] < Cover[replace])))
+    {
+      replace = i;
+      replaceDist = d;
+    }
+  }
+
+  // 最良解より良いか，全ての解から十分離れているときだけ入れる
+  if (cover <= bestCover && nearDist < minDistance) return false;
+
+  int p;
+  if (size < maxSize) p = size++;
+  else if (replace >= 0) p = replace;
+  else return false;
+
+  Cols[p].assign(cols.begin(), cols.end());
+  Cover[p] = cover;
+  return true;
+}
+
+
+// 入っている解を一様ランダムに一つ選ぶ
+template <typename Index>
+int ElitePoolT<Index>::random_member(std::mt19937_64& rnd) const
+{
+  if (size == 0) return -1;
+  return rnd() % size;
+}
+
+
+// 使う幅
+template class ElitePoolT<uint16_t>;
+template class ElitePoolT<int>;
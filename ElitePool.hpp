@@ -0,0 +1,49 @@
+//---------------------------------------------------------------------------
+// GRASP の局所最適解のうち，良くて互いに離れた解を保存するプール
+// path relinking の相手に使う
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+#include <random>
+
+//
+//
+//  Class ElitePoolT  エリート解のプール
+//
+//  解は列番号を昇順に並べたリスト（K 列）とカバー数で持つ．
+//  2つの解の距離は列集合の対称差の大きさ（一方にだけ含まれる列の数）．
+//  新しい解 S は次のときに入れる．
+//    - プールに同じ解がなく，プールの最良解よりカバー数が大きい
+//    - そうでなくても，全ての解との距離が minDistance 以上で，
+//      プールに空きがあるか，S よりカバー数が小さい解がある
+//  プールが一杯のときは，S よりカバー数が小さい解のうち S に一番近いものと入れ替える．
+//  領域は最初に maxSize 個分確保し，追加・入れ替えでは確保しない．
+//
+template <typename Index>
+class ElitePoolT
+{
+ public:
+  int maxSize;                  // プールに入れる解の数の上限
+  int minDistance;              // 解どうしの距離の下限
+  int size;                     // 今入っている解の数
+
+  std::vector<std::vector<Index>> Cols; // Cols[i]: i 番目の解の列（昇順）
+  std::vector<int> Cover;               // Cover[i]: i 番目の解のカバー数
+
+ public:
+  ElitePoolT(int maxSize, int K, int minDistance);
+
+  // 空にする
+  void clear() { size = 0; }
+
+  // 昇順の列リスト a と b の距離（対称差の大きさ）
+  static int distance(const std::vector<Index>& a, const std::vector<Index>& b);
+
+  // 昇順の列リスト cols（カバー数 cover）を入れられれば入れる．入れたら true
+  bool add(const std::vector<Index>& cols, int cover);
+
+  // 入っている解を一様ランダムに一つ選んで番号を返す（空なら -1）
+  int random_member(std::mt19937_64& rnd) const;
+};
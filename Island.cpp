@@ -0,0 +1,132 @@
+#include "Island.hpp"
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//
+//
+//  Class IslandLink
+//
+//
+
+// アドレスを作る（パスが長すぎたら終了）
+static sockaddr_un island_address(const std::string &path)
+{
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path))
+  {
+    printf("Socket path too long: %s\n", path.c_str());
+    exit(1);
+  }
+  strcpy(addr.sun_path, path.c_str());
+  return addr;
+}
+
+
+// コンストラクタ：この島のソケットを開く（前の実行で残ったソケットは消す）
+IslandLink::IslandLink(const std::string &dir, int id, int n)
+  : Id(id), nIslands(n), Dir(dir), fd(-1), nSent(0), nReceived(0)
+{
+  std::string path = socket_path(Id);
+  sockaddr_un addr = island_address(path);
+
+  fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+  if (fd < 0)
+  {
+    printf("Cannot create socket: %s\n", strerror(errno));
+    exit(1);
+  }
+  unlink(path.c_str());
+  if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0)
+  {
+    printf("Cannot bind %s: %s\n", path.c_str(), strerror(errno));
+    exit(1);
+  }
+}
+
+
+// デストラクタ
+IslandLink::~IslandLink()
+{
+  if (fd >= 0)
+  {
+    close(fd);
+    unlink(socket_path(Id).c_str());
+  }
+}
+
+
+// 島 i のソケットのパス
+std::string IslandLink::socket_path(int i) const
+{
+  return Dir + "/island" + std::to_string(i) + ".sock";
+}
+
+
+// 解 cs を他の全ての島に送る
+void IslandLink::send_solution(const SCPsolution &cs)
+{
+  Buffer.resize(4 + cs.K);
+  Buffer[0] = ISLAND_MAGIC;
+  Buffer[1] = Id;
+  Buffer[2] = cs.K;
+  Buffer[3] = cs.num_Cover;
+  for (int k = 0; k < cs.K; k++) Buffer[4 + k] = cs.CS[k];
+
+  for (int i = 0; i < nIslands; i++)
+  {
+    if (i == Id) continue;
+    sockaddr_un addr = island_address(socket_path(i));
+    // 相手がいない（ENOENT, ECONNREFUSED）・一杯（EAGAIN）のときは送らない
+    if (sendto(fd, Buffer.data(), Buffer.size() * sizeof(int32_t), MSG_DONTWAIT,
+               (sockaddr*)&addr, sizeof(addr)) >= 0)
+      nSent++;
+  }
+}
+
+
+// 届いている解を全て受け取り，best より良い解があれば best に入れる
+bool IslandLink::receive_best(SCPinstance &inst, SCPsolution &best)
+{
+  int K = best.K;
+  SCPsolution cand(inst, K);
+  bool updated = false;
+
+  Buffer.resize(4 + K);
+  for (;;)
+  {
+    ssize_t len = recv(fd, Buffer.data(), Buffer.size() * sizeof(int32_t), MSG_DONTWAIT | MSG_TRUNC);
+    if (len < 0) break;         // もう届いていない
+    nReceived++;
+
+    // 形式・K・列番号を確かめる（重複する列があれば捨てる）
+    if (len != (ssize_t)(Buffer.size() * sizeof(int32_t)) ||
+        Buffer[0] != ISLAND_MAGIC || Buffer[2] != K)
+      continue;
+    cand.initialize(inst);
+    bool ok = true;
+    for (int k = 0; k < K && ok; k++)
+    {
+      int c = Buffer[4 + k];
+      if (c < 0 || c >= inst.numColumns || cand.SOLUTION[c] == 1) ok = false;
+      else cand.add_column(inst, c);
+    }
+    if (!ok) continue;
+
+    // カバー数は送られてきた値ではなく数え直した値で比べる
+    if (best.num_Cover < cand.num_Cover)
+    {
+      best.swap(cand);
+      updated = true;
+    }
+  }
+  return updated;
+}
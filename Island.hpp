@@ -0,0 +1,53 @@
+//---------------------------------------------------------------------------
+// 島モデルの並列探索で使うプロセス間の通信
+// 島（rnkc_main のプロセス）ごとに Unix ドメインソケット（データグラム）を1つ開き，
+// 最良解の列リストを他の全ての島に送る．同じマシンの上で島を何個でも動かせる．
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SCPv.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//
+//
+//  Class IslandLink  島どうしで解をやりとりする
+//
+//  島 i のソケットは Dir/island<i>.sock．
+//  送る内容は int32 の列で，[ISLAND_MAGIC, 島の番号, K, カバー数, 列番号 × K]．
+//  送受信はどちらも待たない．まだ始まっていない島・終わった島・受信バッファが一杯の島には
+//  送らずに飛ばす．受け取った解は列番号を確かめ，カバー数を数え直してから使う．
+//
+class IslandLink
+{
+ public:
+  static const int32_t ISLAND_MAGIC = 0x524e4b43; // "RNKC"
+
+  int Id;                       // この島の番号（0 から）
+  int nIslands;                 // 島の数
+  std::string Dir;              // ソケットを置くディレクトリ
+  int fd;                       // この島のソケット
+
+  long nSent;                   // 送った解の数
+  long nReceived;               // 受け取った解の数（使えなかったものも含む）
+
+  std::vector<int32_t> Buffer;  // 送受信用
+
+ public:
+  IslandLink(const std::string &dir, int id, int n);
+  ~IslandLink();
+  IslandLink(const IslandLink&) = delete;
+  IslandLink& operator=(const IslandLink&) = delete;
+
+  // 島 i のソケットのパス
+  std::string socket_path(int i) const;
+
+  // 解 cs を他の全ての島に送る
+  void send_solution(const SCPsolution &cs);
+
+  // 届いている解を全て受け取り，カバー数が best より大きい解があれば一番大きい解を best に入れる
+  // （best の K と違う解・壊れた解は捨てる）．best を入れ替えたら true
+  bool receive_best(SCPinstance &inst, SCPsolution &best);
+};
@@ -0,0 +1,113 @@
+#include "LagrangeBound.hpp"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+//
+//
+//  Class LagrangeBound
+//
+//
+
+// コンストラクタ：λ = 1 から始める
+LagrangeBound::LagrangeBound(SCPinstance &inst, int K)
+  : K(std::min(K, inst.numColumns)), Bound(inst.numRows), Value(inst.numRows),
+    Lower(0), nIter(0), Cancel(false)
+{
+  Lambda.assign(inst.numRows, 1.0);
+  Score.resize(inst.numColumns);
+  Top.resize(inst.numColumns);
+  Count.resize(inst.numRows);
+}
+
+
+// L(λ) を計算する
+double LagrangeBound::evaluate(SCPinstance &inst)
+{
+  double L = 0;
+  for (int i = 0; i < inst.numRows; i++) L += 1.0 - Lambda[i];
+
+  for (int j = 0; j < inst.numColumns; j++)
+  {
+    double s = 0;
+    for (int r : inst.ColEntries[j]) s += Lambda[r];
+    Score[j] = s;
+  }
+
+  // Score の大きい方から K 列
+  Top.resize(inst.numColumns);
+  for (int j = 0; j < inst.numColumns; j++) Top[j] = j;
+  std::nth_element(Top.begin(), Top.begin() + K, Top.end(),
+                   [&](int a, int b) { return Score[a] > Score[b]; });
+  Top.resize(K);
+
+  std::fill(Count.begin(), Count.end(), 0);
+  int cover = 0;
+  for (int j : Top)
+  {
+    L += Score[j];
+    for (int r : inst.ColEntries[j])
+    {
+      if (Count[r]++ == 0) cover++;
+    }
+  }
+  if (Lower < cover) Lower = cover;
+  return L;
+}
+
+
+// 劣勾配法
+int LagrangeBound::solve(SCPinstance &inst, int maxIter, SearchControl *ctl)
+{
+  const double eps = 1e-6;      // 丸め誤差で上界を小さくしすぎないように
+  double theta = 2.0;           // ステップ幅の係数
+  int noImprove = 0;
+
+  if (ctl != NULL) ctl->set_upper_bound(Bound);
+  for (int it = 0; it < maxIter; it++)
+  {
+    if (Cancel.load(std::memory_order_relaxed)) break;
+    if (ctl != NULL && ctl->should_stop()) break;
+
+    double L = evaluate(inst);
+    nIter++;
+    if (L < Value - eps)
+    {
+      Value = L;
+      noImprove = 0;
+      int b = (int)std::floor(Value + eps);
+      if (b < Bound)
+      {
+        Bound = b;
+        if (ctl != NULL) ctl->set_upper_bound(Bound);
+      }
+    }
+    else if (++noImprove >= 20)
+    {
+      theta /= 2;
+      noImprove = 0;
+      if (theta < 1e-3) break;
+    }
+
+    int lower = Lower;
+    if (ctl != NULL) lower = std::max(lower, ctl->best_cover());
+    if (Bound <= lower) break;  // 最適値が分かった
+
+    // 劣勾配 g_i = y_i - Count[i]（y_i = 1 なのは λ_i < 1 の行）
+    double norm = 0;
+    for (int i = 0; i < inst.numRows; i++)
+    {
+      double g = (Lambda[i] < 1.0 ? 1 : 0) - Count[i];
+      norm += g * g;
+    }
+    if (norm == 0) break;       // λ が最適
+
+    double t = theta * (L - lower) / norm;
+    for (int i = 0; i < inst.numRows; i++)
+    {
+      double g = (Lambda[i] < 1.0 ? 1 : 0) - Count[i];
+      Lambda[i] = std::min(1.0, std::max(0.0, Lambda[i] + t * g));
+    }
+  }
+  return Bound;
+}
@@ -0,0 +1,53 @@
+//---------------------------------------------------------------------------
+// 最大 k 被覆問題のラグランジュ緩和による上界（劣勾配法）
+// 探索で見つけた解のカバー数が上界に等しければ最適なので，そこで打ち切れる
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SCPv.hpp"
+#include "SearchControl.hpp"
+#include <vector>
+#include <atomic>
+
+//
+//
+//  Class LagrangeBound
+//
+//  最大 k 被覆問題
+//    max Σ_i y_i   s.t.  y_i <= Σ_{j ∋ i} x_j,  Σ_j x_j = K,  x, y ∈ {0,1}
+//  の被覆の制約を乗数 λ_i（0 <= λ_i <= 1）で緩和すると
+//    L(λ) = Σ_i (1 - λ_i) + （Σ_{i ∈ j} λ_i の大きい方から K 列の和）
+//  で，どの λ でも L(λ) は最適値以上．カバー数は整数なので floor(L(λ)) も上界になる．
+//  劣勾配法（Polyak のステップ幅）で L(λ) を小さくする．緩和問題で選んだ K 列は
+//  そのまま実行可能解なので，そのカバー数を下界に使う．
+//  λ = 0 のときの L は行数，λ = 1 のときの L は大きい方から K 列の大きさの和なので，
+//  上界はこの2つ（自明な上界）以下になる．
+//
+class LagrangeBound
+{
+ public:
+  int K;
+  int Bound;                    // 上界（floor(Value)）
+  double Value;                 // それまでの L(λ) の最小値
+  int Lower;                    // 緩和問題で選んだ K 列のカバー数の最大値
+  int nIter;                    // 劣勾配法の反復の数
+  std::atomic<bool> Cancel;     // 別のスレッドから止める
+
+  std::vector<double> Lambda;   // Lambda[i]: 行 i の乗数
+  std::vector<double> Score;    // Score[j]: 列 j の行の乗数の和
+  std::vector<int> Top;         // 緩和問題で選んだ K 列
+  std::vector<int> Count;       // Count[i]: Top のうち行 i をカバーする列の数
+
+ public:
+  LagrangeBound(SCPinstance &inst, int K);
+
+  // 劣勾配法を maxIter 回まで続ける（上界が下界に等しくなったら終わる）．
+  // ctl があれば，上界が下がるたびに ctl に知らせ，ctl の最良解のカバー数も下界に使い，
+  // ctl が打ち切られたら止まる．戻り値は上界
+  int solve(SCPinstance &inst, int maxIter, SearchControl *ctl = NULL);
+
+ private:
+  // L(λ) を計算する（Top と Count も作る）．戻り値は L(λ)
+  double evaluate(SCPinstance &inst);
+};
@@ -0,0 +1,103 @@
+#include "Profile.hpp"
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef RNKC_PROFILE
+
+// 終わったスレッドの計測値の合計
+static ProfileData TotalProfile;
+static std::mutex TotalMutex;
+
+static const char* COUNTER_NAME[PROF_NUM_COUNTERS] = {
+  "add_column", "remove_column", "add_update_score", "remove_update_score",
+  "get_column_maxscore", "best_swap_column", "get_column_grasp", "lazy_gain"
+};
+static const char* PHASE_NAME[PROF_NUM_PHASES] = { "construction", "local_search", "path_relinking" };
+
+static void add_profile(ProfileData& to, const ProfileData& from)
+{
+  for (int i = 0; i < PROF_NUM_COUNTERS; i++)
+  {
+    to.calls[i] += from.calls[i];
+    to.entries[i] += from.entries[i];
+    to.scores[i] += from.scores[i];
+  }
+  for (int p = 0; p < PROF_NUM_PHASES; p++)
+  {
+    to.phase_calls[p] += from.phase_calls[p];
+    to.phase_ticks[p] += from.phase_ticks[p];
+  }
+}
+
+
+thread_local ThreadProfileData ThreadProfile;
+
+// 時刻
+uint64_t profile_ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// ticks とミリ秒の換算のため，最初に使われた時刻を覚えておく
+static uint64_t StartTicks = profile_ticks();
+static std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+
+ThreadProfileData::ThreadProfileData()
+{
+  memset((ProfileData*)this, 0, sizeof(ProfileData));
+}
+
+ThreadProfileData::~ThreadProfileData()
+{
+  std::lock_guard<std::mutex> lock(TotalMutex);
+  add_profile(TotalProfile, *this);
+  memset((ProfileData*)this, 0, sizeof(ProfileData));
+}
+
+
+// 全スレッドの計測値を合計して表示する
+void profile_report(FILE *fp)
+{
+  ProfileData sum;
+  {
+    std::lock_guard<std::mutex> lock(TotalMutex);
+    sum = TotalProfile;
+  }
+  add_profile(sum, ThreadProfile);
+
+  // 1 tick が何ミリ秒か
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+  uint64_t ticks = profile_ticks() - StartTicks;
+  double ms_per_tick = ticks > 0 ? ms / ticks : 0;
+
+  fprintf(fp, "# profile: %-20s %14s %16s %16s\n", "function", "calls", "entries", "score_updates");
+  for (int i = 0; i < PROF_NUM_COUNTERS; i++)
+  {
+    fprintf(fp, "# profile: %-20s %14ld %16ld %16ld\n",
+            COUNTER_NAME[i], sum.calls[i], sum.entries[i], sum.scores[i]);
+  }
+  fprintf(fp, "# profile: %-20s %14s %16s %16s\n", "phase", "calls", "ticks", "ms");
+  for (int p = 0; p < PROF_NUM_PHASES; p++)
+  {
+    fprintf(fp, "# profile: %-20s %14ld %16lu %16.3f\n", PHASE_NAME[p], sum.phase_calls[p],
+            (unsigned long)sum.phase_ticks[p], sum.phase_ticks[p] * ms_per_tick);
+  }
+}
+
+#else
+
+// 計測なしでコンパイルしたときは何も表示しない
+void profile_report(FILE *fp)
+{
+}
+
+#endif
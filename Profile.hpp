@@ -0,0 +1,89 @@
+//---------------------------------------------------------------------------
+// 計測用のカウンタとタイマー
+// RNKC_PROFILE を定義してコンパイルしたときだけ有効（make PROFILE=1）
+// 定義しなければマクロは空になり，何もコストはかからない
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+
+// 数える関数
+enum ProfileCounter
+{
+  PROF_ADD_COLUMN,              // SCPsolution::add_column
+  PROF_REMOVE_COLUMN,           // SCPsolution::remove_column
+  PROF_ADD_UPDATE_SCORE,        // add_update_score
+  PROF_REMOVE_UPDATE_SCORE,     // remove_update_score
+  PROF_GET_COLUMN_MAXSCORE,     // get_column_maxscore
+  PROF_BEST_SWAP,               // best_swap_column（局所探索の交換の評価）
+  PROF_GET_COLUMN_GRASP,        // get_column_grasp
+  PROF_LAZY_GAIN,               // lazy_greedy_construction で gain を計算し直した回数
+  PROF_NUM_COUNTERS
+};
+
+// 時間を計る段階
+enum ProfilePhase
+{
+  PHASE_CONSTRUCTION,           // 初期解の生成
+  PHASE_LOCAL_SEARCH,           // 局所探索
+  PHASE_PATH_RELINKING,         // path relinking
+  PROF_NUM_PHASES
+};
+
+// スレッドごとの計測値
+struct ProfileData
+{
+  long calls[PROF_NUM_COUNTERS];        // 呼ばれた回数
+  long entries[PROF_NUM_COUNTERS];      // たどった隣接リストの要素（や列）の数
+  long scores[PROF_NUM_COUNTERS];       // スコアを増減した回数
+  long phase_calls[PROF_NUM_PHASES];
+  uint64_t phase_ticks[PROF_NUM_PHASES];
+};
+
+// 全スレッドの計測値を合計して fp に表示する
+// 終わったスレッドの分はスレッドの終了時に合計されている．呼んだスレッドの分もここで足す．
+void profile_report(FILE *fp);
+
+
+#ifdef RNKC_PROFILE
+
+// スレッドごとの計測値（スレッドが終わるときに全体に足し込む）
+struct ThreadProfileData : public ProfileData
+{
+  ThreadProfileData();
+  ~ThreadProfileData();
+};
+extern thread_local ThreadProfileData ThreadProfile;
+
+// 時刻（x86 では rdtsc，それ以外では steady_clock のナノ秒）
+uint64_t profile_ticks();
+
+// 生存期間の時間を段階 p に足す
+class ProfileTimer
+{
+  ProfilePhase phase;
+  uint64_t start;
+ public:
+  ProfileTimer(ProfilePhase p) : phase(p), start(profile_ticks()) {}
+  ~ProfileTimer()
+  {
+    ThreadProfile.phase_calls[phase]++;
+    ThreadProfile.phase_ticks[phase] += profile_ticks() - start;
+  }
+};
+
+#define PROF_CALL(c, n)     (ThreadProfile.calls[c]++, ThreadProfile.entries[c] += (n))
+#define PROF_ENTRIES(c, n)  (ThreadProfile.entries[c] += (n))
+#define PROF_SCORES(c, n)   (ThreadProfile.scores[c] += (n))
+#define PROF_PHASE(p)       ProfileTimer prof_timer_(p)
+
+#else
+
+#define PROF_CALL(c, n)     ((void)0)
+#define PROF_ENTRIES(c, n)  ((void)0)
+#define PROF_SCORES(c, n)   ((void)0)
+#define PROF_PHASE(p)       ((void)0)
+
+#endif
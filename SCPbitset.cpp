@@ -0,0 +1,297 @@
+#include "SCPbitset.hpp"
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <immintrin.h>
+
+//
+//
+//  popcount(a & ~b) の実装
+//
+//
+
+// スカラー版
+static void popcount_andnot_scalar(const Word* a, const Word* b, int nwords, int n, int* out)
+{
+  for (int j = 0; j < n; j++, a += nwords)
+  {
+    int cnt = 0;
+    for (int i = 0; i < nwords; i++) cnt += __builtin_popcountll(a[i] & ~b[i]);
+    out[j] = cnt;
+  }
+}
+
+
+// AVX2 版：4ビットごとに表引きして（vpshufb），バイトごとの和を vpsadbw でまとめる
+__attribute__((target("avx2")))
+static void popcount_andnot_avx2(const Word* a, const Word* b, int nwords, int n, int* out)
+{
+  const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                       0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low = _mm256_set1_epi8(0x0f);
+  const __m256i zero = _mm256_setzero_si256();
+
+  for (int j = 0; j < n; j++, a += nwords)
+  {
+    __m256i acc = _mm256_setzero_si256();
+    for (int i = 0; i < nwords; i += 4)
+    {
+      __m256i x = _mm256_andnot_si256(_mm256_loadu_si256((const __m256i*)(b + i)),
+                                      _mm256_loadu_si256((const __m256i*)(a + i)));
+      __m256i lo = _mm256_and_si256(x, low);
+      __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), low);
+      __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+      acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, zero));
+    }
+
+    out[j] = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+      + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+  }
+}
+
+
+// AVX-512 (BW) 版：AVX2 版と同じ方法を512ビットで行う
+// （GCC 12 のヘッダ内の _mm512_undefined_* で誤った未初期化警告が出るので抑える）
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f,avx512bw")))
+static void popcount_andnot_avx512bw(const Word* a, const Word* b, int nwords, int n, int* out)
+{
+  const __m512i lut = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+  const __m512i low = _mm512_set1_epi8(0x0f);
+  const __m512i zero = _mm512_setzero_si512();
+
+  for (int j = 0; j < n; j++, a += nwords)
+  {
+    __m512i acc = _mm512_setzero_si512();
+    for (int i = 0; i < nwords; i += 8)
+    {
+      __m512i x = _mm512_andnot_si512(_mm512_loadu_si512((const void*)(b + i)),
+                                      _mm512_loadu_si512((const void*)(a + i)));
+      __m512i lo = _mm512_and_si512(x, low);
+      __m512i hi = _mm512_and_si512(_mm512_srli_epi16(x, 4), low);
+      __m512i cnt = _mm512_add_epi8(_mm512_shuffle_epi8(lut, lo), _mm512_shuffle_epi8(lut, hi));
+      acc = _mm512_add_epi64(acc, _mm512_sad_epu8(cnt, zero));
+    }
+
+    out[j] = _mm512_reduce_add_epi64(acc);
+  }
+}
+#pragma GCC diagnostic pop
+
+
+// popcount を選ぶ
+PopcountAndnotFn select_popcount_andnot(const char* name)
+{
+  __builtin_cpu_init();
+  bool has_avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+  bool has_avx2 = __builtin_cpu_supports("avx2");
+
+  if (name == NULL)
+  {
+    if (has_avx512) return popcount_andnot_avx512bw;
+    if (has_avx2) return popcount_andnot_avx2;
+    return popcount_andnot_scalar;
+  }
+
+  if (strcmp(name, "avx512bw") == 0) return has_avx512 ? popcount_andnot_avx512bw : NULL;
+  if (strcmp(name, "avx2") == 0) return has_avx2 ? popcount_andnot_avx2 : NULL;
+  if (strcmp(name, "scalar") == 0) return popcount_andnot_scalar;
+  return NULL;
+}
+
+
+// popcount の名前
+const char* popcount_kernel_name(PopcountAndnotFn fn)
+{
+  if (fn == popcount_andnot_avx512bw) return "avx512bw";
+  if (fn == popcount_andnot_avx2) return "avx2";
+  if (fn == popcount_andnot_scalar) return "scalar";
+  return "unknown";
+}
+
+
+
+//
+//
+//  Class SCPbitinstance
+//
+//
+
+// コンストラクタ
+SCPbitinstance::SCPbitinstance(SCPinstance &inst)
+{
+  numRows = inst.numRows;
+  numColumns = inst.numColumns;
+
+  // 64ビット単位に切り上げてから BITSET_ALIGN 語単位に切り上げる
+  nWords = (numRows + 63) / 64;
+  nWords = (nWords + BITSET_ALIGN - 1) / BITSET_ALIGN * BITSET_ALIGN;
+
+  BITS.assign((size_t)numColumns * nWords, 0);
+  for (int j = 0; j < numColumns; j++)
+  {
+    Word* col = BITS.data() + (size_t)j * nWords;
+    for (int r : inst.ColEntries[j]) col[r / 64] |= (Word)1 << (r % 64);
+  }
+
+  popcount_andnot = select_popcount_andnot();
+}
+
+
+// デストラクタ
+SCPbitinstance::~SCPbitinstance()
+{
+}
+
+
+
+//
+//
+// Class SCPbitsolution
+//
+//
+
+// コンストラクタ
+SCPbitsolution::SCPbitsolution(SCPbitinstance &binst, int k)
+{
+  nRow = binst.numRows;
+  nCol = binst.numColumns;
+  K = k;
+
+  CS.resize(K);
+  SOLUTION.resize(nCol);
+  COVERED.resize(binst.nWords);
+  COVERED2.resize(binst.nWords);
+
+  initialize(binst);
+}
+
+
+// デストラクタ
+SCPbitsolution::~SCPbitsolution()
+{
+}
+
+
+// 候補解を初期化
+void SCPbitsolution::initialize(SCPbitinstance &binst)
+{
+  num_Cover = 0;
+
+  for (int j = 0; j < nCol; ++j) SOLUTION[j] = 0;
+  for (int w = 0; w < binst.nWords; ++w)
+  {
+    COVERED[w] = 0;
+    COVERED2[w] = 0;
+  }
+
+  // cs には最初は大きい値を詰めておく
+  for (int j = 0; j < K; j++) CS[j] = nCol + 1;
+}
+
+
+// CSに列cを追加する
+void SCPbitsolution::add_column(SCPbitinstance &binst, int c)
+{
+  if (SOLUTION[c])
+  {
+    printf("Column %d has already contained in CS\n", c);
+    exit(1);
+  }
+
+  SOLUTION[c] = 1;
+
+  // CSの中がソート済みになるように列cを追加
+  int j = 0;
+  while (c > CS[j]) j++;
+  for (int jj = K-1; jj > j; jj--) CS[jj] = CS[jj - 1];
+  CS[j] = c;
+
+  num_Cover += gain(binst, c);
+
+  const Word* col = binst.column(c);
+  for (int w = 0; w < binst.nWords; ++w)
+  {
+    COVERED2[w] |= COVERED[w] & col[w];
+    COVERED[w] |= col[w];
+  }
+} // End add_column
+
+
+// CSから列cを削除する
+void SCPbitsolution::remove_column(SCPbitinstance &binst, int c)
+{
+  if (SOLUTION[c] == 0)
+  {
+    printf("Column %d is not contained in CS\n", c);
+    exit(1);
+  }
+
+  SOLUTION[c] = 0;
+
+  // CSの中がソート済みになるように列cを削除
+  int j = 0;
+  while (c > CS[j]) j++;
+  for (int jj = j; jj < K - 1; ++jj) CS[jj] = CS[jj + 1];
+  CS[K-1] = nCol + 1;
+
+  // 2回以上カバーされている行は区別できないので，残りの列から作り直す
+  num_Cover -= loss(binst, c);
+  for (int w = 0; w < binst.nWords; ++w)
+  {
+    COVERED[w] = 0;
+    COVERED2[w] = 0;
+  }
+  for (int cc : CS)
+  {
+    if (cc >= nCol) break;
+    const Word* col = binst.column(cc);
+    for (int w = 0; w < binst.nWords; ++w)
+    {
+      COVERED2[w] |= COVERED[w] & col[w];
+      COVERED[w] |= col[w];
+    }
+  }
+} // End remove_column
+
+
+// CSに含まれない全ての列の gain を score に入れる（CSの列は -loss）
+void SCPbitsolution::compute_scores(SCPbitinstance &binst, std::vector<int>& score) const
+{
+  // 全ての列をまとめて一度に計算してから，CSの列だけ直す
+  binst.popcount_andnot(binst.BITS.data(), COVERED.data(), binst.nWords, nCol, score.data());
+  for (int c : CS)
+  {
+    if (c >= nCol) break;
+    score[c] = -loss(binst, c);
+  }
+}
+
+
+// 解の中身を other と入れ替える
+void SCPbitsolution::swap(SCPbitsolution &other)
+{
+  std::swap(nRow, other.nRow);
+  std::swap(nCol, other.nCol);
+  std::swap(K, other.K);
+  std::swap(num_Cover, other.num_Cover);
+  CS.swap(other.CS);
+  SOLUTION.swap(other.SOLUTION);
+  COVERED.swap(other.COVERED);
+  COVERED2.swap(other.COVERED2);
+}
+
+
+// CSの中身を表示
+void SCPbitsolution::print_solution()
+{
+  for (int i = 0; i < K - 1; ++i)
+  {
+    printf("%d ", CS[i] + 1);
+  }
+  printf("\n");
+} // End print_solution
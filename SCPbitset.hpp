@@ -0,0 +1,115 @@
+//---------------------------------------------------------------------------
+// ビット集合で被覆を管理するクラス
+// 密なインスタンス（scpnrg1 など）向け
+// 列ごとに「カバーする行」のビット集合を持ち，列の得点を
+//   popcount(列 & ~COVERED)
+// で計算する．popcount は AVX-512 / AVX2 / スカラーを実行時に選ぶ．
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SCPv.hpp"
+#include <vector>
+#include <cstdint>
+
+// ビット集合の1語（64ビット）
+typedef uint64_t Word;
+
+// 列のビット集合は BITSET_ALIGN 語（= 512ビット）単位に切り上げて持つ
+const int BITSET_ALIGN = 8;
+
+// n 本のビット集合 a[j * nwords ..] それぞれについて
+//   out[j] = sum_i popcount(a[j * nwords + i] & ~b[i])
+// を計算する（nwords は BITSET_ALIGN の倍数）
+typedef void (*PopcountAndnotFn)(const Word* a, const Word* b, int nwords, int n, int* out);
+
+// popcount を選ぶ
+// name が NULL なら実行中のCPUで使える一番速いもの，
+// "avx512bw", "avx2", "scalar" ならそれ（CPUが対応していなければ NULL を返す）
+PopcountAndnotFn select_popcount_andnot(const char* name = NULL);
+
+// popcount の名前
+const char* popcount_kernel_name(PopcountAndnotFn fn);
+
+
+//
+//
+//  Class SCPbitinstance  列ごとの行ビット集合
+//
+//
+class SCPbitinstance
+{
+ public:
+  int numRows;
+  int numColumns;
+  int nWords;                   // 列1本あたりの語数（BITSET_ALIGN の倍数）
+  std::vector<Word> BITS;       // BITS[j * nWords ..]: 列jがカバーする行の集合
+  PopcountAndnotFn popcount_andnot;
+
+ public:
+  SCPbitinstance(SCPinstance &inst);
+  ~SCPbitinstance();
+
+  // 列jのビット集合の先頭
+  const Word* column(int j) const { return BITS.data() + (size_t)j * nWords; }
+};
+
+
+//
+//
+//  Class SCPbitsolution  ビット集合で候補解を管理するクラス
+//
+//  SCPsolution と同じ add_column / remove_column で使える．
+//  COVERED は1回以上，COVERED2 は2回以上カバーされている行の集合．
+//
+class SCPbitsolution
+{
+ public:
+  int nRow;                     // 行数
+  int nCol;                     // 列数
+  int K;                        // 選択する列の数
+
+  int num_Cover;                // カバーされた行の数
+  std::vector<int> CS;          // CS: 候補解（列番号のリスト）
+  std::vector<int> SOLUTION;    // SOLUTION[j] = 1: 列jが候補解に含まれる
+  std::vector<Word> COVERED;    // 1回以上カバーされている行
+  std::vector<Word> COVERED2;   // 2回以上カバーされている行
+
+ public:
+  SCPbitsolution(SCPbitinstance &binst, int k);
+  ~SCPbitsolution();
+
+  // 候補解を初期化
+  void initialize(SCPbitinstance &binst);
+
+  // CSに列cを追加する
+  void add_column(SCPbitinstance &binst, int c);
+
+  // CSから列cを削除する（COVERED と COVERED2 は残りの列から作り直す）
+  void remove_column(SCPbitinstance &binst, int c);
+
+  // 列c（CSに含まれない）を追加したときに新たにカバーされる行の数
+  int gain(SCPbitinstance &binst, int c) const
+  {
+    int g;
+    binst.popcount_andnot(binst.column(c), COVERED.data(), binst.nWords, 1, &g);
+    return g;
+  }
+
+  // 列c（CSに含まれる）を削除したときにカバーされなくなる行の数
+  int loss(SCPbitinstance &binst, int c) const
+  {
+    int l;
+    binst.popcount_andnot(binst.column(c), COVERED2.data(), binst.nWords, 1, &l);
+    return l;
+  }
+
+  // CSに含まれない全ての列の gain を score に入れる（CSの列は -loss）
+  void compute_scores(SCPbitinstance &binst, std::vector<int>& score) const;
+
+  // 解の中身を other と入れ替える（領域はコピーしない）
+  void swap(SCPbitsolution &other);
+
+  // CSの中身を表示
+  void print_solution();
+};
@@ -0,0 +1,508 @@
+#include "SCPcompact.hpp"
+#include "Profile.hpp"
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <algorithm>
+
+
+// インスタンスに使える一番小さい幅を返す
+SCPwidth select_width(SCPinstance &inst)
+{
+  if (width_fits(inst, WIDTH_COMPACT)) return WIDTH_COMPACT;
+  return WIDTH_WIDE;
+}
+
+
+// 幅 w でインスタンスを扱えるか
+// compact では列番号（CS の番兵 numColumns+1 を含む）と行番号が uint16_t に，
+// スコア（列がカバーする行の数以下）が int16_t に収まればよい
+bool width_fits(SCPinstance &inst, SCPwidth w)
+{
+  if (w == WIDTH_WIDE) return true;
+
+  if (inst.numColumns + 1 > std::numeric_limits<uint16_t>::max()) return false;
+  if (inst.numRows > std::numeric_limits<uint16_t>::max()) return false;
+  for (int j = 0; j < inst.numColumns; j++)
+  {
+    if (inst.ColEntries[j].size() > std::numeric_limits<int16_t>::max()) return false;
+  }
+  return true;
+}
+
+
+// 幅の名前
+const char* width_name(SCPwidth w)
+{
+  return (w == WIDTH_COMPACT) ? "compact" : "wide";
+}
+
+
+//
+//
+//  Class SCPinstanceT
+//
+//
+
+// CSR のリストを Index 型にコピーする
+template <typename Index>
+static void copy_csr(const CSRList &src, CSRListT<Index> &dst)
+{
+  int n = src.size();
+  dst.StartData.assign(src.Start, src.Start + n + 1);
+  dst.IndexData.resize(src.num_entries());
+  for (long e = 0; e < src.num_entries(); e++) dst.IndexData[e] = (Index)src.Index[e];
+  dst.use_data();
+}
+
+// int のときはコピーせずに元の配列を指す
+static void copy_csr(const CSRList &src, CSRListT<int> &dst)
+{
+  dst.use_view(src.size(), src.Start, src.Index);
+}
+
+
+// コンストラクタ
+template <typename Index>
+SCPinstanceT<Index>::SCPinstanceT(SCPinstance &inst, bool reduce, int K, bool reorder)
+{
+  if (reduce) reduce_from(inst, K);
+  else
+  {
+    numRows = inst.numRows;
+    numColumns = inst.numColumns;
+
+    copy_csr(inst.ColEntries, ColEntries);
+    copy_csr(inst.RowCovers, RowCovers);
+
+    RowWeight.assign(numRows, 1);
+    ColumnId.resize(numColumns);
+    for (int j = 0; j < numColumns; j++) ColumnId[j] = j;
+  }
+  if (reorder) reorder_rcm();
+
+  ColWeight.assign(numColumns, 0);
+  maxColumnWeight = 0;
+  for (int j = 0; j < numColumns; j++)
+  {
+    int w = 0;
+    for (int r : ColEntries[j]) w += RowWeight[r];
+    ColWeight[j] = w;
+    if (maxColumnWeight < w) maxColumnWeight = w;
+  }
+
+  ReducedColumn.assign(inst.numColumns, -1);
+  for (int j = 0; j < numColumns; j++) ReducedColumn[ColumnId[j]] = j;
+}
+
+
+// 重複する行をまとめ，支配される列を除いたインスタンスを作る
+template <typename Index>
+void SCPinstanceT<Index>::reduce_from(SCPinstance &inst, int K)
+{
+  int nRow = inst.numRows;
+  int nCol = inst.numColumns;
+
+  // 行ごとのカバーする列のリスト（比べるために整列しておく）
+  std::vector<int> rowStart(nRow + 1, 0);
+  std::vector<int> rowData;
+  rowData.reserve(inst.RowCovers.num_entries());
+  for (int i = 0; i < nRow; i++)
+  {
+    rowData.insert(rowData.end(), inst.RowCovers[i].begin(), inst.RowCovers[i].end());
+    rowStart[i + 1] = rowData.size();
+    std::sort(rowData.begin() + rowStart[i], rowData.end());
+  }
+
+  // カバーする列の集合が同じ行は，整列すると隣り合う
+  std::vector<int> rows;
+  for (int i = 0; i < nRow; i++)
+  {
+    if (rowStart[i + 1] > rowStart[i]) rows.push_back(i);
+  }
+  auto same_row = [&](int a, int b)
+  {
+    return std::equal(rowData.begin() + rowStart[a], rowData.begin() + rowStart[a + 1],
+                      rowData.begin() + rowStart[b], rowData.begin() + rowStart[b + 1]);
+  };
+  std::sort(rows.begin(), rows.end(), [&](int a, int b)
+  {
+    bool less = std::lexicographical_compare(rowData.begin() + rowStart[a], rowData.begin() + rowStart[a + 1],
+                                             rowData.begin() + rowStart[b], rowData.begin() + rowStart[b + 1]);
+    if (less) return true;
+    if (same_row(a, b)) return a < b;
+    return false;
+  });
+
+  // newRow[i]: 元の行iをまとめた行の番号（どの列にもカバーされない行は -1）
+  // rep[r]: まとめた行 r の代表（番号の一番小さい元の行）
+  std::vector<int> newRow(nRow, -1);
+  std::vector<int> rep;
+  std::vector<int> weight;
+  for (size_t k = 0; k < rows.size(); k++)
+  {
+    if (k == 0 || !same_row(rows[k - 1], rows[k]))
+    {
+      rep.push_back(rows[k]);
+      weight.push_back(0);
+    }
+    newRow[rows[k]] = rep.size() - 1;
+    weight.back()++;
+  }
+  int mRow = rep.size();
+
+  // まとめた行で表した列ごとの行のリスト（重複なし）
+  std::vector<int> colStart(nCol + 1, 0);
+  std::vector<int> colData;
+  for (int j = 0; j < nCol; j++)
+  {
+    for (int r : inst.ColEntries[j])
+    {
+      if (newRow[r] >= 0) colData.push_back(newRow[r]);
+    }
+    std::sort(colData.begin() + colStart[j], colData.end());
+    colData.erase(std::unique(colData.begin() + colStart[j], colData.end()), colData.end());
+    colStart[j + 1] = colData.size();
+  }
+
+  // 列jの行の集合が列kの行の集合に含まれるかを，
+  // 列jの行をカバーする列ごとに「何行を共有するか」を数えて調べる
+  std::vector<int> shared(nCol, 0);
+  std::vector<int> touched;
+  std::vector<char> keep(nCol, 1);
+  int nKeep = nCol;
+  for (int j = 0; j < nCol; j++)
+  {
+    int sj = colStart[j + 1] - colStart[j];
+    touched.clear();
+    for (int e = colStart[j]; e < colStart[j + 1]; e++)
+    {
+      int r = rep[colData[e]];
+      for (int k = rowStart[r]; k < rowStart[r + 1]; k++)
+      {
+        int c = rowData[k];
+        if (shared[c]++ == 0) touched.push_back(c);
+      }
+    }
+
+    bool dominated = false;
+    if (sj == 0)
+    {
+      dominated = (nCol > 1);   // 何もカバーしない列
+    }
+    for (int c : touched)
+    {
+      int sc = colStart[c + 1] - colStart[c];
+      if (c != j && shared[c] == sj && (sc > sj || c < j)) dominated = true;
+      shared[c] = 0;
+    }
+
+    if (dominated)
+    {
+      keep[j] = 0;
+      nKeep--;
+    }
+  }
+
+  // K 列選べるだけの列を残す
+  for (int j = 0; j < nCol && nKeep < K; j++)
+  {
+    if (!keep[j])
+    {
+      keep[j] = 1;
+      nKeep++;
+    }
+  }
+
+  // 縮小したインスタンスを作る
+  numRows = mRow;
+  numColumns = nKeep;
+  RowWeight.assign(weight.begin(), weight.end());
+  ColumnId.clear();
+  for (int j = 0; j < nCol; j++)
+  {
+    if (keep[j]) ColumnId.push_back(j);
+  }
+
+  std::vector<int>& cs = ColEntries.StartData;
+  std::vector<Index>& ci = ColEntries.IndexData;
+  std::vector<int> nCov(numRows + 1, 0);
+  cs.assign(1, 0);
+  ci.clear();
+  for (int j : ColumnId)
+  {
+    for (int e = colStart[j]; e < colStart[j + 1]; e++)
+    {
+      ci.push_back(colData[e]);
+      nCov[colData[e] + 1]++;
+    }
+    cs.push_back(ci.size());
+  }
+  ColEntries.use_data();
+
+  // 行ごとのリストは列ごとのリストを転置して作る
+  std::vector<int>& rs = RowCovers.StartData;
+  std::vector<Index>& ri = RowCovers.IndexData;
+  rs.assign(numRows + 1, 0);
+  for (int i = 0; i < numRows; i++) rs[i + 1] = rs[i] + nCov[i + 1];
+  ri.resize(ci.size());
+  std::vector<int> pos(rs.begin(), rs.end() - 1);
+  for (int j = 0; j < numColumns; j++)
+  {
+    for (int r : ColEntries[j]) ri[pos[r]++] = j;
+  }
+  RowCovers.use_data();
+}
+
+
+// 行と列の番号を Reverse Cuthill-McKee 順に付け替える
+// 列と行を頂点とする2部グラフを，次数の小さい列から幅優先にたどり，
+// 訪れた順（隣の頂点は次数の小さい順）に列と行の番号を付けて，最後に順序を逆にする．
+// どの列にもカバーされない行は最後に置く．
+template <typename Index>
+void SCPinstanceT<Index>::reorder_rcm()
+{
+  int nRow = numRows;
+  int nCol = numColumns;
+
+  std::vector<int> colOrder, rowOrder;  // 訪れた順の（元の）列番号・行番号
+  colOrder.reserve(nCol);
+  rowOrder.reserve(nRow);
+  std::vector<char> colSeen(nCol, 0), rowSeen(nRow, 0);
+  std::vector<int> queue;               // 列 j は j，行 i は nCol + i
+  std::vector<int> nbr;
+  queue.reserve(nCol + nRow);
+
+  std::vector<int> starts(nCol);
+  for (int j = 0; j < nCol; j++) starts[j] = j;
+  std::stable_sort(starts.begin(), starts.end(), [&](int a, int b)
+  {
+    return ColEntries[a].size() < ColEntries[b].size();
+  });
+
+  for (int s : starts)
+  {
+    if (colSeen[s]) continue;
+    colSeen[s] = 1;
+    queue.clear();
+    queue.push_back(s);
+    for (size_t q = 0; q < queue.size(); q++)
+    {
+      int v = queue[q];
+      nbr.clear();
+      if (v < nCol)
+      {
+        colOrder.push_back(v);
+        for (int r : ColEntries[v])
+        {
+          if (!rowSeen[r]) { rowSeen[r] = 1; nbr.push_back(nCol + r); }
+        }
+        std::stable_sort(nbr.begin(), nbr.end(), [&](int a, int b)
+        {
+          return RowCovers[a - nCol].size() < RowCovers[b - nCol].size();
+        });
+      }
+      else
+      {
+        rowOrder.push_back(v - nCol);
+        for (int c : RowCovers[v - nCol])
+        {
+          if (!colSeen[c]) { colSeen[c] = 1; nbr.push_back(c); }
+        }
+        std::stable_sort(nbr.begin(), nbr.end(), [&](int a, int b)
+        {
+          return ColEntries[a].size() < ColEntries[b].size();
+        });
+      }
+      queue.insert(queue.end(), nbr.begin(), nbr.end());
+    }
+  }
+  std::reverse(colOrder.begin(), colOrder.end());
+  std::reverse(rowOrder.begin(), rowOrder.end());
+  for (int i = 0; i < nRow; i++)
+  {
+    if (!rowSeen[i]) rowOrder.push_back(i);
+  }
+
+  std::vector<int> newRow(nRow);
+  for (int i = 0; i < nRow; i++) newRow[rowOrder[i]] = i;
+
+  // 新しい番号で列ごとのリストを作る
+  std::vector<int> cs(1, 0);
+  std::vector<Index> ci;
+  std::vector<int> nCov(nRow + 1, 0);
+  ci.reserve(ColEntries.num_entries());
+  cs.reserve(nCol + 1);
+  for (int j : colOrder)
+  {
+    size_t first = ci.size();
+    for (int r : ColEntries[j])
+    {
+      ci.push_back(newRow[r]);
+      nCov[newRow[r] + 1]++;
+    }
+    std::sort(ci.begin() + first, ci.end());
+    cs.push_back(ci.size());
+  }
+
+  std::vector<Index> weight(nRow);
+  for (int i = 0; i < nRow; i++) weight[i] = RowWeight[rowOrder[i]];
+  std::vector<int> id(nCol);
+  for (int j = 0; j < nCol; j++) id[j] = ColumnId[colOrder[j]];
+
+  ColEntries.StartData.swap(cs);
+  ColEntries.IndexData.swap(ci);
+  ColEntries.use_data();
+  RowWeight.swap(weight);
+  ColumnId.swap(id);
+
+  // 行ごとのリストは列ごとのリストを転置して作る
+  std::vector<int>& rs = RowCovers.StartData;
+  std::vector<Index>& ri = RowCovers.IndexData;
+  rs.assign(nRow + 1, 0);
+  for (int i = 0; i < nRow; i++) rs[i + 1] = rs[i] + nCov[i + 1];
+  ri.resize(ColEntries.num_entries());
+  std::vector<int> pos(rs.begin(), rs.end() - 1);
+  for (int j = 0; j < nCol; j++)
+  {
+    for (int r : ColEntries[j]) ri[pos[r]++] = j;
+  }
+  RowCovers.use_data();
+}
+
+
+//
+//
+//  Class SCPsolutionT
+//
+//
+
+// コンストラクタ
+template <typename Index, typename Counter>
+SCPsolutionT<Index, Counter>::SCPsolutionT(SCPinstanceT<Index> &inst, int k)
+{
+  nRow = inst.numRows;
+  nCol = inst.numColumns;
+  K = k;
+
+  CS.resize(K);
+  SELECTED.resize((nCol + 63) / 64);
+  COVERED.resize(nRow);
+
+  initialize(inst);
+}
+
+
+// 候補解を初期化
+template <typename Index, typename Counter>
+void SCPsolutionT<Index, Counter>::initialize(SCPinstanceT<Index> &inst)
+{
+  num_Cover = 0;
+
+  for (size_t w = 0; w < SELECTED.size(); ++w) SELECTED[w] = 0;
+  for (int i = 0; i < nRow; ++i) COVERED[i] = 0;
+
+  // cs には最初は大きい値を詰めておく
+  for (int j = 0; j < K; j++) CS[j] = nCol + 1;
+}
+
+
+// CSに列cを追加する
+template <typename Index, typename Counter>
+void SCPsolutionT<Index, Counter>::add_column(SCPinstanceT<Index> &inst, int c)
+{
+  PROF_CALL(PROF_ADD_COLUMN, inst.ColEntries[c].size());
+  if (is_selected(c))
+  {
+    printf("Column %d has already contained in CS\n", c);
+    exit(1);
+  }
+
+  SELECTED[c >> 6] |= (uint64_t)1 << (c & 63);
+
+  // CSの中がソート済みになるように列cを追加
+  int j = 0;
+  while (c > CS[j]) j++;
+  for (int jj = K-1; jj > j; jj--) CS[jj] = CS[jj - 1];
+  CS[j] = c;
+
+  for (int r : inst.ColEntries[c]) // 列cがカバーする行
+  {
+    if (COVERED[r] == 0) num_Cover += inst.RowWeight[r]; // r行が初めてカバーされた
+    if (COVERED[r] != COUNTER_MAX) COVERED[r]++;
+  }
+} // End add_column
+
+
+// CSから列cを削除する
+template <typename Index, typename Counter>
+void SCPsolutionT<Index, Counter>::remove_column(SCPinstanceT<Index> &inst, int c)
+{
+  PROF_CALL(PROF_REMOVE_COLUMN, inst.ColEntries[c].size());
+  if (!is_selected(c))
+  {
+    printf("Column %d is not contained in CS\n", c);
+    exit(1);
+  }
+
+  SELECTED[c >> 6] &= ~((uint64_t)1 << (c & 63));
+
+  // CSの中がソート済みになるように列cを削除
+  int j = 0;
+  while (c > CS[j]) j++;
+  for (int jj = j; jj < K-1; ++jj) CS[jj] = CS[jj + 1];
+  CS[K-1] = nCol + 1;
+
+  for (int r : inst.ColEntries[c]) // 列cがカバーする行
+  {
+    if (COVERED[r] == COUNTER_MAX)
+    {
+      // 頭打ちなので残っている列から数え直す
+      int n = 0;
+      for (int rc : inst.RowCovers[r])
+      {
+        if (is_selected(rc) && n < COUNTER_MAX) n++;
+      }
+      COVERED[r] = n;
+    }
+    else COVERED[r]--;
+
+    if (COVERED[r] == 0) num_Cover -= inst.RowWeight[r]; // r行がカバーされなくなった
+  }
+} // End remove_column
+
+
+// 解の中身を other と入れ替える
+template <typename Index, typename Counter>
+void SCPsolutionT<Index, Counter>::swap(SCPsolutionT &other)
+{
+  std::swap(nRow, other.nRow);
+  std::swap(nCol, other.nCol);
+  std::swap(K, other.K);
+  std::swap(num_Cover, other.num_Cover);
+  CS.swap(other.CS);
+  SELECTED.swap(other.SELECTED);
+  COVERED.swap(other.COVERED);
+}
+
+
+// 同じ列（元のインスタンスの列番号）を選んだ SCPsolution を out に作る
+template <typename Index, typename Counter>
+void SCPsolutionT<Index, Counter>::to_solution(SCPinstanceT<Index> &cinst,
+                                               SCPinstance &inst,
+                                               SCPsolution &out) const
+{
+  out.initialize(inst);
+  for (int c : CS)
+  {
+    if (c < nCol) out.add_column(inst, cinst.ColumnId[c]);
+  }
+}
+
+
+// 使う幅の組み合わせ
+template class SCPinstanceT<uint16_t>;
+template class SCPinstanceT<int>;
+template class SCPsolutionT<uint16_t, uint8_t>;
+template class SCPsolutionT<int, int>;
@@ -0,0 +1,128 @@
+//---------------------------------------------------------------------------
+// 添字と被覆回数の幅を選べるインスタンスと候補解
+// 列数が 65535 未満なら列番号・行番号を uint16_t，被覆回数を uint8_t にして，
+// スレッドごとに持つ作業領域を小さくする（L2 に収める）．
+// どちらの幅を使うかはインスタンスを読み込んだ後に select_width で決める．
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SCPv.hpp"
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+// 探索で使う整数の幅
+enum SCPwidth
+{
+  WIDTH_COMPACT,                // 添字 uint16_t，被覆回数 uint8_t
+  WIDTH_WIDE                    // 添字 int，被覆回数 int（元の SCPsolution と同じ）
+};
+
+// インスタンスに使える一番小さい幅を返す
+SCPwidth select_width(SCPinstance &inst);
+
+// 幅 w でインスタンスを扱えるか
+bool width_fits(SCPinstance &inst, SCPwidth w);
+
+// 幅の名前（"compact" / "wide"）
+const char* width_name(SCPwidth w);
+
+
+//
+//
+//  Class SCPinstanceT  添字を Index 型で持つインスタンス
+//
+//  SCPinstance から作る．Index が int のときは SCPinstance の配列をそのまま指し，
+//  それ以外は Index 型にコピーする．
+//
+//  reduce を指定すると，探索の前にインスタンスを小さくする．
+//    - カバーする列の集合が同じ行を1つの行にまとめ，まとめた行の数を重みにする
+//      （どの列にもカバーされない行は除く）
+//    - カバーする行の集合が他の列の部分集合になっている列を除く
+//      （同じ集合の列は番号の小さい方を残す．残る列が K 列より少なくなるときは
+//       除いた列を番号順に戻す）
+//  カバー数と列のスコアは行の重みの和で数える．列番号は ColumnId で元に戻す．
+//
+//  reorder を指定すると，行と列の番号を付け替えて，一緒にアクセスされる行どうし・
+//  列どうしを近い番号にする（行と列の2部グラフの Reverse Cuthill-McKee 順）．
+//  COVERED[r] や score[c] へのアクセスがまとまり，キャッシュミスが減る．
+//  付け替えた後も列番号は ColumnId で元に戻せる．
+//
+template <typename Index>
+class SCPinstanceT
+{
+ public:
+  int numRows;
+  int numColumns;
+  int maxColumnWeight;          // 列がカバーする行の重みの和の最大値
+
+  CSRListT<Index> ColEntries;   // ColEntries[j]: 列jがカバーする行
+  CSRListT<Index> RowCovers;    // RowCovers[i]: 行iをカバーする列
+  std::vector<Index> RowWeight; // RowWeight[i]: 行iの重み（まとめた元の行の数）
+  std::vector<Index> ColWeight; // ColWeight[j]: 列jがカバーする行の重みの和
+
+  std::vector<int> ColumnId;    // ColumnId[j]: 列jの元のインスタンスでの番号
+  std::vector<int> ReducedColumn; // ReducedColumn[c]: 元の列cの縮小後の番号（除いた列は -1）
+
+ public:
+  SCPinstanceT(SCPinstance &inst, bool reduce = false, int K = 0, bool reorder = false);
+  SCPinstanceT(const SCPinstanceT&) = delete;
+  SCPinstanceT& operator=(const SCPinstanceT&) = delete;
+
+ private:
+  // 重複する行をまとめ，支配される列を除いたインスタンスを作る
+  void reduce_from(SCPinstance &inst, int K);
+
+  // 行と列の番号を Reverse Cuthill-McKee 順に付け替える
+  void reorder_rcm();
+};
+
+
+//
+//
+//  Class SCPsolutionT  添字と被覆回数の幅を選べる候補解
+//
+//  SCPsolution と同じ add_column / remove_column で使える．
+//  num_Cover はカバーされた行の重みの和．
+//  SELECTED は列ごとに1ビットの選択フラグ．
+//  COVERED は Counter の最大値で頭打ちにし，頭打ちの行から列を削除するときは
+//  RowCovers[r] と SELECTED から数え直す（K 列のうち 255 列以上が同じ行を
+//  カバーすることはほとんどないので，数え直しはまず起きない）．
+//
+template <typename Index, typename Counter>
+class SCPsolutionT
+{
+ public:
+  int nRow;                     // 行数
+  int nCol;                     // 列数
+  int K;                        // 選択する列の数
+
+  int num_Cover;                // カバーされた行の数
+  std::vector<Index> CS;        // CS: 候補解（列番号のリスト）
+  std::vector<uint64_t> SELECTED; // 列jが候補解に含まれるとき j ビット目が 1
+  std::vector<Counter> COVERED; // COVERED[i]: 行iがカバーされている回数（頭打ちあり）
+
+  static const int COUNTER_MAX = std::numeric_limits<Counter>::max();
+
+ public:
+  SCPsolutionT(SCPinstanceT<Index> &inst, int k);
+
+  // 候補解を初期化
+  void initialize(SCPinstanceT<Index> &inst);
+
+  // 列cが候補解に含まれているか
+  bool is_selected(int c) const { return (SELECTED[c >> 6] >> (c & 63)) & 1; }
+
+  // CSに列cを追加する
+  void add_column(SCPinstanceT<Index> &inst, int c);
+
+  // CSから列cを削除する
+  void remove_column(SCPinstanceT<Index> &inst, int c);
+
+  // 解の中身を other と入れ替える（領域はコピーしない）
+  void swap(SCPsolutionT &other);
+
+  // 同じ列（元のインスタンスの列番号）を選んだ SCPsolution を out に作る
+  void to_solution(SCPinstanceT<Index> &cinst, SCPinstance &inst, SCPsolution &out) const;
+};
@@ -0,0 +1,177 @@
+#include "SCPstream.hpp"
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <utility>
+#include <sys/stat.h>
+
+//
+//
+//  Class SCPcolumnStream
+//
+//
+
+// コンストラクタ：ヘッダを読み，ColStart と ColIndex の位置を求める
+SCPcolumnStream::SCPcolumnStream(const char *FileName)
+  : StartFile(NULL), IndexFile(NULL)
+{
+  struct stat st;
+  SCPBinaryHeader header;
+  StartFile = fopen(FileName, "rb");
+  if (StartFile == NULL || stat(FileName, &st) != 0
+      || fread(&header, sizeof(header), 1, StartFile) != 1
+      || memcmp(header.magic, SCP_BINARY_MAGIC, sizeof(header.magic)) != 0)
+  {
+    if (StartFile != NULL) fclose(StartFile);
+    throw DataException();
+  }
+  numRows = header.numRows;
+  numColumns = header.numColumns;
+  numEntries = header.numEntries;
+
+  // ファイルの大きさがヘッダと合っているか（SCPinstance::map_binary と同じ）
+  size_t expected = sizeof(SCPBinaryHeader)
+    + sizeof(int) * ((size_t)numColumns + (numRows + 1) + numEntries + (numColumns + 1) + numEntries);
+  if (numRows < 0 || numColumns < 0 || numEntries < 0 || (size_t)st.st_size != expected)
+  {
+    fclose(StartFile);
+    throw DataException();
+  }
+  StartOffset = sizeof(SCPBinaryHeader) + sizeof(int) * ((long)numColumns + (numRows + 1) + numEntries);
+  IndexOffset = StartOffset + sizeof(int) * ((long)numColumns + 1);
+
+  IndexFile = fopen(FileName, "rb");
+  if (IndexFile == NULL)
+  {
+    fclose(StartFile);
+    throw DataException();
+  }
+  rewind();
+}
+
+
+// デストラクタ
+SCPcolumnStream::~SCPcolumnStream()
+{
+  fclose(StartFile);
+  fclose(IndexFile);
+}
+
+
+// 最初の列に戻る
+void SCPcolumnStream::rewind()
+{
+  if (fseek(StartFile, StartOffset, SEEK_SET) != 0
+      || fread(&prevStart, sizeof(int), 1, StartFile) != 1 || prevStart != 0
+      || fseek(IndexFile, IndexOffset, SEEK_SET) != 0)
+    throw DataException();
+  nextColumn = 0;
+}
+
+
+// 次の列を読む
+bool SCPcolumnStream::next(int &j, std::vector<int> &rows)
+{
+  if (nextColumn >= numColumns) return false;
+
+  int start;
+  if (fread(&start, sizeof(int), 1, StartFile) != 1
+      || start < prevStart || start > numEntries)
+    throw DataException();
+
+  int n = start - prevStart;
+  rows.resize(n);
+  if (n > 0 && fread(rows.data(), sizeof(int), n, IndexFile) != (size_t)n)
+    throw DataException();
+  for (int r : rows)
+  {
+    if (r < 0 || r >= numRows) throw DataException();
+  }
+
+  j = nextColumn++;
+  prevStart = start;
+  return true;
+}
+
+
+
+//
+//
+//  Class SieveStreaming
+//
+//
+
+// コンストラクタ
+SieveStreaming::SieveStreaming(int numRows, int K, double eps)
+  : numRows(numRows), K(K), eps(eps), maxSingleton(0)
+{
+}
+
+
+// m が変わったときに v の範囲を合わせる
+void SieveStreaming::update_thresholds()
+{
+  double base = std::log(1 + eps);
+  int lo = (int)std::ceil(std::log((double)maxSingleton) / base);
+  int hi = (int)std::floor(std::log(2.0 * K * maxSingleton) / base);
+
+  // m <= v でなくなった集合を捨てる
+  int drop = 0;
+  while (drop < (int)Sieves.size() && Sieves[drop].expo < lo) drop++;
+  Sieves.erase(Sieves.begin(), Sieves.begin() + drop);
+
+  // 2Km までの新しい v を足す
+  int from = Sieves.empty() ? lo : Sieves.back().expo + 1;
+  for (int e = from; e <= hi; e++)
+  {
+    Sieve s;
+    s.expo = e;
+    s.v = std::pow(1 + eps, e);
+    s.cover = 0;
+    s.cols.reserve(K);
+    s.covered.assign((numRows + 63) / 64, 0);
+    Sieves.push_back(std::move(s));
+  }
+}
+
+
+// 列 j を読んだ
+void SieveStreaming::add(int j, const std::vector<int> &rows)
+{
+  if ((int)rows.size() > maxSingleton)
+  {
+    maxSingleton = rows.size();
+    update_thresholds();
+  }
+
+  for (Sieve &s : Sieves)
+  {
+    int n = s.cols.size();
+    if (n >= K) continue;
+
+    // 新たにカバーする行の数
+    int gain = 0;
+    for (int r : rows)
+    {
+      if (!((s.covered[r >> 6] >> (r & 63)) & 1)) gain++;
+    }
+    if (gain == 0 || gain < (s.v / 2 - s.cover) / (K - n)) continue;
+
+    for (int r : rows) s.covered[r >> 6] |= (uint64_t)1 << (r & 63);
+    s.cover += gain;
+    s.cols.push_back(j);
+  }
+}
+
+
+// カバー数が最大の集合
+const SieveStreaming::Sieve* SieveStreaming::best() const
+{
+  const Sieve *b = NULL;
+  for (const Sieve &s : Sieves)
+  {
+    if (b == NULL || b->cover < s.cover) b = &s;
+  }
+  return b;
+}
@@ -0,0 +1,91 @@
+//---------------------------------------------------------------------------
+// メモリに載らない大きなインスタンスのためのストリーミング解法
+// バイナリ形式（scp2bin）のファイルの列の部分を先頭から1列ずつ読み，
+// sieve-streaming で K 列を選ぶ．インスタンス全体（RowCovers, ColEntries）は持たない．
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SCPv.hpp"
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+//
+//
+//  Class SCPcolumnStream  バイナリ形式のファイルから列を1列ずつ読む
+//
+//  ColStart と ColIndex をそれぞれ別の FILE で先頭から順に読むので，
+//  メモリは1列分しか使わない．形式が正しくなければ DataException を投げる．
+//
+class SCPcolumnStream
+{
+ public:
+  int  numRows;
+  int  numColumns;
+  long numEntries;
+
+ public:
+  SCPcolumnStream(const char *FileName);
+  ~SCPcolumnStream();
+  SCPcolumnStream(const SCPcolumnStream&) = delete;
+  SCPcolumnStream& operator=(const SCPcolumnStream&) = delete;
+
+  // 最初の列に戻る
+  void rewind();
+
+  // 次の列を読む．列番号を j に，カバーする行を rows に入れる．最後の列の次は false
+  bool next(int &j, std::vector<int> &rows);
+
+ private:
+  FILE *StartFile;              // ColStart を読む
+  FILE *IndexFile;              // ColIndex を読む
+  long StartOffset;             // ファイルの中の ColStart の位置
+  long IndexOffset;             // ファイルの中の ColIndex の位置
+  int  nextColumn;              // 次に読む列
+  int  prevStart;               // ColStart[nextColumn]
+};
+
+
+//
+//
+//  Class SieveStreaming  sieve-streaming（Badanidiyuru et al. 2014）
+//
+//  最適値 OPT の候補 v = (1+eps)^i を m <= v <= 2Km の範囲で持ち（m はそれまでの列の
+//  カバー数の最大値），v ごとに列の集合 S_v とカバーした行のビット集合を持つ．
+//  列 e は |S_v| < K で，新たにカバーする行の数が (v/2 - f(S_v)) / (K - |S_v|) 以上
+//  （かつ 1 以上）なら S_v に加える．最良の S_v は OPT の (1/2 - eps) 倍以上をカバーする．
+//  メモリは v の数（log(2K) / log(1+eps) 程度）× (numRows ビット + K 列)．
+//
+class SieveStreaming
+{
+ public:
+  // 候補 v ごとの集合
+  struct Sieve
+  {
+    int expo;                   // v = (1+eps)^expo
+    double v;
+    int cover;                  // f(S_v)
+    std::vector<int> cols;      // S_v
+    std::vector<uint64_t> covered; // S_v がカバーした行
+  };
+
+  int numRows;
+  int K;
+  double eps;
+  int maxSingleton;             // それまでの列のカバー数の最大値 m
+  std::vector<Sieve> Sieves;    // expo の昇順
+
+ public:
+  SieveStreaming(int numRows, int K, double eps);
+
+  // 列 j（カバーする行 rows）を読んだ
+  void add(int j, const std::vector<int> &rows);
+
+  // カバー数が最大の集合（列を読む前は NULL）
+  const Sieve* best() const;
+
+ private:
+  // m が変わったときに v の範囲を合わせる（範囲外の集合は捨て，新しい v は空の集合から始める）
+  void update_thresholds();
+};
@@ -1,7 +1,15 @@
 #include "SCPv.hpp"
 #include <vector>
 #include <iostream>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "Random.hpp"
+#include "Profile.hpp"
 
 extern Rand rnd;
 
@@ -13,96 +21,305 @@ extern Rand rnd;
 
 // コンストラクタ
 SCPinstance::SCPinstance(FILE *SourceFile)
+  : MapAddr(NULL), MapSize(0)
 {
   if (SourceFile == NULL) throw DataException();
+  else read_text(SourceFile);
+
+  finish_load();
+}
+// End: コンストラクタ
+
+
+// コンストラクタ（ファイル名から）
+// 先頭が SCPBIN1 ならバイナリ形式として mmap し，そうでなければテキスト形式として読む
+SCPinstance::SCPinstance(const char *FileName)
+  : MapAddr(NULL), MapSize(0)
+{
+  int fd = open(FileName, O_RDONLY);
+  if (fd < 0) throw DataException();
+
+  struct stat st;
+  SCPBinaryHeader header;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(header)
+      && pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header)
+      && memcmp(header.magic, SCP_BINARY_MAGIC, sizeof(header.magic)) == 0)
+  {
+    // 途中で例外を投げるとデストラクタは呼ばれないので，ここで fd と mmap を片付ける
+    try
+    {
+      map_binary(fd, st.st_size);
+    }
+    catch (DataException&)
+    {
+      close(fd);
+      unmap();
+      throw;
+    }
+    close(fd);
+  }
   else
   {
-    int R, C, cost;
-    fscanf(SourceFile, "%d", &R);
-    fscanf(SourceFile, "%d", &C);
-    numRows = R;
-    numColumns = C;
-
-    int* nCov = new int [numColumns];
-    int* idx = new int [numColumns];
-    for (int j = 0; j < numColumns; j++) {
-      nCov[j] = 0;
-      idx[j] = 0;
+    close(fd);
+    FILE *SourceFile = fopen(FileName, "r");
+    if (SourceFile == NULL) throw DataException();
+    try
+    {
+      read_text(SourceFile);
     }
+    catch (DataException&)
+    {
+      fclose(SourceFile);
+      throw;
+    }
+    fclose(SourceFile);
+  }
+
+  try
+  {
+    finish_load();
+  }
+  catch (DataException&)
+  {
+    unmap();
+    throw;
+  }
+}
+// End: コンストラクタ
 
 
-    // read costs
-    for(int j = 0; j < C; j++)
+// コンストラクタ（列のリストから）
+// Columns[j] は列jがカバーする行の番号（0 から nRows-1）．ストリーミングで部分インスタンスを作るときに使う
+SCPinstance::SCPinstance(int nRows, const std::vector<std::vector<int>> &Columns)
+  : MapAddr(NULL), MapSize(0)
+{
+  numRows = nRows;
+  numColumns = Columns.size();
+  CostData.assign(numColumns, 1);
+  Cost = IndexList(CostData.data(), CostData.data() + numColumns);
+
+  // 列の情報
+  std::vector<int>& ColStart = ColEntries.StartData;
+  std::vector<int>& ColIndex = ColEntries.IndexData;
+  std::vector<int> nCov(numRows + 1, 0);
+  ColStart.resize(numColumns + 1);
+  ColStart[0] = 0;
+  for (int j = 0; j < numColumns; j++)
+  {
+    for (int r : Columns[j])
     {
-      fscanf(SourceFile, "%d", &cost);
-      Cost.push_back(cost);
+      if (r < 0 || r >= numRows) throw DataException();
+      ColIndex.push_back(r);
+      nCov[r + 1]++;
     }
+    ColStart[j + 1] = ColIndex.size();
+    std::sort(ColIndex.begin() + ColStart[j], ColIndex.end()); // 列の中の行は昇順にしておく
+  }
+  ColEntries.use_data();
+
+  // 行の情報（列の情報を転置する）
+  std::vector<int>& RowStart = RowCovers.StartData;
+  std::vector<int>& RowIndex = RowCovers.IndexData;
+  RowStart.resize(numRows + 1);
+  RowStart[0] = 0;
+  for (int i = 0; i < numRows; i++)
+    RowStart[i + 1] = RowStart[i] + nCov[i + 1];
+
+  std::vector<int> idx(RowStart.begin(), RowStart.end() - 1);
+  RowIndex.resize(ColIndex.size());
+  for (int j = 0; j < numColumns; j++)
+  {
+    for (int r : ColEntries[j]) {
+      RowIndex[idx[r]] = j;
+      idx[r]++;
+    }
+  }
+  RowCovers.use_data();
+
+  finish_load();
+}
+// End: コンストラクタ
+
 
-    // ファイルから各行の情報を読む
-    int CoverNo, CoverID;
-    std::vector<int> cov;
+// テキスト形式（OR-Library）を読む
+void SCPinstance::read_text(FILE *SourceFile)
+{
+  int R, C, cost;
+  fscanf(SourceFile, "%d", &R);
+  fscanf(SourceFile, "%d", &C);
+  numRows = R;
+  numColumns = C;
+
+  // read costs
+  CostData.reserve(C);
+  for(int j = 0; j < C; j++)
+  {
+    fscanf(SourceFile, "%d", &cost);
+    CostData.push_back(cost);
+  }
+  Cost = IndexList(CostData.data(), CostData.data() + C);
+
+  // ファイルから各行の情報を読む
+  // RowCovers.IndexData に全ての行のリストを続けて詰めていく
+  int CoverNo, CoverID;
+  std::vector<int> nCov(numColumns + 1, 0);
+  std::vector<int>& RowStart = RowCovers.StartData;
+  std::vector<int>& RowIndex = RowCovers.IndexData;
+
+  RowStart.resize(numRows + 1);
+  RowStart[0] = 0;
+  for(int i = 0;  i < numRows; i++)
+  {
+    if (fscanf(SourceFile, "%d", &CoverNo) == EOF)
+      throw (DataException());
 
-    for(int i = 0;  i < numRows; i++)
+    for(int j = 0; j < CoverNo; j++)
     {
-      if (fscanf(SourceFile, "%d", &CoverNo) == EOF)
+      if (fscanf(SourceFile,"%d", &CoverID) == EOF)
         throw (DataException());
 
-      cov.clear();
-      for(int j = 0; j < CoverNo; j++)
+      if (CoverID >= 1 && CoverID <= numColumns)
       {
-        if (fscanf(SourceFile,"%d", &CoverID) == EOF)
-          throw (DataException());
-
-        if (CoverID >= 1 && CoverID <= numColumns)
-        {
-          cov.push_back(CoverID - 1);
-          nCov[CoverID - 1]++;
-        }
-        else
-          throw (DataException());
+        RowIndex.push_back(CoverID - 1);
+        nCov[CoverID]++;
       }
-
-      RowCovers.push_back(cov);
+      else
+        throw (DataException());
     }
-    // ファイルの読み込み終了
 
-    // 列の情報を作成
-    for (int j = 0; j < numColumns; ++j) {
-      std::vector<int> c(nCov[j]);
-      ColEntries.push_back(c);
+    RowStart[i + 1] = RowIndex.size();
+  }
+  RowCovers.use_data();
+  // ファイルの読み込み終了
+
+  // 列の情報を作成
+  // nCov の累積和が各列の先頭位置になる
+  std::vector<int>& ColStart = ColEntries.StartData;
+  std::vector<int>& ColIndex = ColEntries.IndexData;
+
+  ColStart.resize(numColumns + 1);
+  ColStart[0] = 0;
+  for (int j = 0; j < numColumns; ++j)
+    ColStart[j + 1] = ColStart[j] + nCov[j + 1];
+
+  std::vector<int> idx(ColStart.begin(), ColStart.end() - 1);
+  ColIndex.resize(RowIndex.size());
+  for (int i = 0; i < numRows; i++)
+  {
+    for (int c : RowCovers[i]) {
+      ColIndex[idx[c]] = i;
+      idx[c]++;
     }
+  }
+  ColEntries.use_data();
+  // 列の情報の作成終了
+}
 
-    for (int i = 0; i < numRows; i++)
-    {
-      for (int c : RowCovers[i]) {
-        ColEntries[c][idx[c]] = i;
-        idx[c]++;
-      }
-    }
-    // 列の情報の作成終了
-    delete [] nCov;
-    delete [] idx;
+
+// CSR 形式のリスト（n 個）が正しいか：Start[0] == 0，Start が減らない，Start[n] == nnz，
+// 添字が全て [0, bound) に入っている
+static bool valid_csr(int n, const int *start, const int *index, long nnz, int bound)
+{
+  if (start[0] != 0 || start[n] != nnz) return false;
+  for (int i = 0; i < n; i++)
+  {
+    if (start[i + 1] < start[i]) return false;
   }
-  // 処理は終了
+  for (long k = 0; k < nnz; k++)
+  {
+    if (index[k] < 0 || index[k] >= bound) return false;
+  }
+  return true;
+}
 
 
+// バイナリ形式のファイルを mmap して，コピーせずにそのまま使う
+// 中身（行・列のリストの範囲と添字）も確かめ，正しくなければ DataException
+// （MapAddr はそのまま残すので，呼び出し側で unmap する）
+void SCPinstance::map_binary(int fd, size_t size)
+{
+  void *addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) throw DataException();
+  MapAddr = addr;
+  MapSize = size;
+
+  const SCPBinaryHeader *header = (const SCPBinaryHeader *)addr;
+  numRows = header->numRows;
+  numColumns = header->numColumns;
+  long nnz = header->numEntries;
+
+  // ファイルの大きさがヘッダと合っているか
+  size_t expected = sizeof(SCPBinaryHeader)
+    + sizeof(int) * ((size_t)numColumns + ((size_t)numRows + 1) + nnz + ((size_t)numColumns + 1) + nnz);
+  if (numRows < 0 || numColumns < 0 || nnz < 0 || size != expected)
+    throw DataException();
+
+  const int *p = (const int *)(header + 1);
+  Cost = IndexList(p, p + numColumns);
+  p += numColumns;
+  RowCovers.use_view(numRows, p, p + numRows + 1);
+  p += numRows + 1 + nnz;
+  ColEntries.use_view(numColumns, p, p + numColumns + 1);
+
+  if (!valid_csr(numRows, RowCovers.Start, RowCovers.Index, nnz, numColumns) ||
+      !valid_csr(numColumns, ColEntries.Start, ColEntries.Index, nnz, numRows))
+    throw DataException();
+}
+
+
+// バイナリ形式で書き出す
+void SCPinstance::write_binary(const char *FileName)
+{
+  FILE *fp = fopen(FileName, "wb");
+  if (fp == NULL) throw DataException();
+
+  SCPBinaryHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SCP_BINARY_MAGIC, sizeof(header.magic));
+  header.numRows = numRows;
+  header.numColumns = numColumns;
+  header.numEntries = RowCovers.num_entries();
+
+  long nnz = header.numEntries;
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  ok = ok && fwrite(Cost.begin(), sizeof(int), numColumns, fp) == (size_t)numColumns;
+  ok = ok && fwrite(RowCovers.Start, sizeof(int), numRows + 1, fp) == (size_t)numRows + 1;
+  ok = ok && fwrite(RowCovers.Index, sizeof(int), nnz, fp) == (size_t)nnz;
+  ok = ok && fwrite(ColEntries.Start, sizeof(int), numColumns + 1, fp) == (size_t)numColumns + 1;
+  ok = ok && fwrite(ColEntries.Index, sizeof(int), nnz, fp) == (size_t)nnz;
+
+  if (fclose(fp) != 0 || !ok) throw DataException();
+}
+
+
+// 密度を計算して簡単なチェックをする
+void SCPinstance::finish_load()
+{
   // 簡単な方法でデータの正しさを確認
-  long Sum1 = 0, Sum2 = 0;
-  for (int i = 0; i < numRows; i++) Sum1 += RowCovers[i].size();
-  for (int j = 0; j < numColumns; j++) Sum2 += ColEntries[j].size();
+  long Sum1 = RowCovers.num_entries();
+  long Sum2 = ColEntries.num_entries();
 
   //Incorrect Source File!
   if (Sum1 != Sum2)  throw (DataException());
 
   // 密度の計算
-  Density = (float)Sum1/(numColumns * numRows);
+  Density = (float)Sum1/((double)numColumns * numRows);
 }
-// End: コンストラクタ
 
 
 // デストラクタ
 SCPinstance::~SCPinstance()
 {
+  unmap();
+}
+
+
+// mmap したファイルを解放する
+void SCPinstance::unmap()
+{
+  if (MapAddr != NULL) munmap(MapAddr, MapSize);
+  MapAddr = NULL;
+  MapSize = 0;
 }
 // End: デストラクタ
 
@@ -168,6 +385,7 @@ void SCPsolution::initialize(SCPinstance &inst)
 void SCPsolution::add_column(SCPinstance &inst,
                              int c)
 {
+  PROF_CALL(PROF_ADD_COLUMN, inst.ColEntries[c].size());
   if (SOLUTION[c])
   {
     printf("Column %d has already contained in CS\n", c);
@@ -200,6 +418,7 @@ void SCPsolution::add_column(SCPinstance &inst,
 // CSから列cを削除する
 void SCPsolution::remove_column(SCPinstance &inst, int c)
 {
+  PROF_CALL(PROF_REMOVE_COLUMN, inst.ColEntries[c].size());
   if (SOLUTION[c] == 0)
   {
     printf("Column %d is not contained in CS\n", c);
@@ -211,7 +430,7 @@ void SCPsolution::remove_column(SCPinstance &inst, int c)
   // CSの中がソート済みになるように列cを削除
   int j = 0;
   while (c > CS[j]) j++;
-  for (int jj = j; jj < K; ++jj) CS[jj] = CS[jj + 1];
+  for (int jj = j; jj < K-1; ++jj) CS[jj] = CS[jj + 1];
   CS[K-1] = inst.numColumns + 1;
 
   for (int r : inst.ColEntries[c]) // 列cがカバーする行
@@ -227,6 +446,20 @@ void SCPsolution::remove_column(SCPinstance &inst, int c)
 } // End remove_column
 
 
+// 解の中身を other と入れ替える
+// 最良解の保存などで使う．ベクトルの中身を交換するだけなので O(1)
+void SCPsolution::swap(SCPsolution &other)
+{
+  std::swap(nRow, other.nRow);
+  std::swap(nCol, other.nCol);
+  std::swap(K, other.K);
+  std::swap(num_Cover, other.num_Cover);
+  CS.swap(other.CS);
+  SOLUTION.swap(other.SOLUTION);
+  COVERED.swap(other.COVERED);
+}
+
+
 // CSの中身を表示
 void SCPsolution::print_solution()
 {
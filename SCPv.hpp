@@ -11,6 +11,110 @@
 #include <vector>
 #include <cstdio>
 
+//
+//
+//  Class IndexListT  連続した配列の一部を指す（std::span の代わり）
+//
+//  T は添字の型（SCPinstance は int，SCPinstanceT<uint16_t> は uint16_t）
+//
+template <typename T>
+class IndexListT
+{
+ public:
+  const T* first;
+  const T* last;
+
+ public:
+  IndexListT() : first(NULL), last(NULL) {}
+  IndexListT(const T* f, const T* l) : first(f), last(l) {}
+
+  const T* begin() const { return first; }
+  const T* end() const { return last; }
+  int size() const { return last - first; }
+  int operator[](int i) const { return first[i]; }
+};
+
+typedef IndexListT<int> IndexList;
+
+
+//
+//
+//  Class CSRList  リストのリストを CSR 形式（オフセット配列 + 連続した添字配列）で持つ
+//
+//  i 番目のリストは Index[Start[i]] .. Index[Start[i+1]-1]
+//  Start と Index は StartData/IndexData か，mmap したバイナリファイルの中を指す
+//  T は Index の要素の型（Start は要素の総数を数えるので常に int）
+//
+template <typename T>
+class CSRListT
+{
+ public:
+  int numLists;                 // リストの数
+  const int* Start;             // Start[i]: i番目のリストの先頭位置（大きさは numLists+1）
+  const T* Index;               // すべてのリストを連結した配列
+
+  std::vector<int> StartData;   // テキストから読んだときの Start の実体
+  std::vector<T> IndexData;     // テキストから読んだときの Index の実体
+
+ public:
+  CSRListT() : numLists(0), Start(NULL), Index(NULL) {}
+  CSRListT(const CSRListT&) = delete;
+  CSRListT& operator=(const CSRListT&) = delete;
+
+  // StartData/IndexData を使う
+  void use_data()
+  {
+    numLists = (int)StartData.size() - 1;
+    Start = StartData.data();
+    Index = IndexData.data();
+  }
+
+  // 外部の配列（mmap した領域など）を使う
+  void use_view(int n, const int* s, const T* idx)
+  {
+    numLists = n;
+    Start = s;
+    Index = idx;
+  }
+
+  IndexListT<T> operator[](int i) const
+  {
+    return IndexListT<T>(Index + Start[i], Index + Start[i + 1]);
+  }
+
+  // リストの数
+  int size() const { return numLists; }
+
+  // 要素の総数
+  long num_entries() const { return Start[numLists]; }
+};
+
+typedef CSRListT<int> CSRList;
+
+
+//
+//  バイナリ形式のインスタンスファイル（scp2bin で作る）
+//
+//    SCPBinaryHeader
+//    int Cost[numColumns]
+//    int RowStart[numRows + 1]
+//    int RowIndex[numEntries]
+//    int ColStart[numColumns + 1]
+//    int ColIndex[numEntries]
+//
+//  すべて実行するマシンのバイトオーダーのまま書き出す．
+//
+#define SCP_BINARY_MAGIC "SCPBIN1"
+
+struct SCPBinaryHeader
+{
+  char magic[8];                // "SCPBIN1"
+  int  numRows;
+  int  numColumns;
+  long numEntries;              // 行列の非零要素の数
+};
+
+
 //
 //
 //  Class SCPinstance  SCPのインスタンスを管理するクラス
@@ -25,11 +129,36 @@ class SCPinstance
 
  public:
   SCPinstance(FILE *SourceFile);
+  SCPinstance(const char *FileName); // テキスト形式かバイナリ形式かはファイルの先頭で判定
+  SCPinstance(int nRows, const std::vector<std::vector<int>> &Columns); // 列のリストから作る（コストは1）
   ~SCPinstance();
 
-  std::vector<std::vector<int> > RowCovers;	// 行をカバーする列のリスト
-  std::vector<std::vector<int> > ColEntries;	// 列がカバーする行のリスト
-  std::vector<int> Cost;
+  SCPinstance(const SCPinstance&) = delete;
+  SCPinstance& operator=(const SCPinstance&) = delete;
+
+  CSRList RowCovers;		// 行をカバーする列のリスト
+  CSRList ColEntries;		// 列がカバーする行のリスト
+  IndexList Cost;		// 列のコスト
+
+  // バイナリ形式で書き出す
+  void write_binary(const char *FileName);
+
+ private:
+  std::vector<int> CostData;    // テキストから読んだときの Cost の実体
+  void*  MapAddr;               // mmap したバイナリファイルの先頭（テキストのときは NULL）
+  size_t MapSize;
+
+  // テキスト形式（OR-Library）を読む
+  void read_text(FILE *SourceFile);
+
+  // バイナリ形式のファイルを mmap して，コピーせずにそのまま使う
+  void map_binary(int fd, size_t size);
+
+  // mmap したファイルを解放する（mmap していなければ何もしない）
+  void unmap();
+
+  // 密度を計算して簡単なチェックをする
+  void finish_load();
 };
 
 class DataException {};
@@ -66,6 +195,9 @@ class SCPsolution
   // CSから列cを削除する
   void remove_column(SCPinstance &inst, int c);
 
+  // 解の中身を other と入れ替える（領域はコピーしない）
+  void swap(SCPsolution &other);
+
   // CSの中身を表示
   void print_solution();
 
@@ -0,0 +1,166 @@
+#include "ScoreBucket.hpp"
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+
+//
+//
+//  Class ScoreBucketT
+//
+//
+
+// コンストラクタ
+template <typename Index>
+ScoreBucketT<Index>::ScoreBucketT(SCPinstanceT<Index> &inst)
+{
+  nCol = inst.numColumns;
+  maxBucket = inst.maxColumnWeight;
+
+  score.resize(nCol, 0);
+  ORDER.resize(nCol, 0);
+  POS.resize(nCol, 0);
+  HEAD.resize(maxBucket + 2, 0);
+
+  initialize(inst);
+}
+
+
+// デストラクタ
+template <typename Index>
+ScoreBucketT<Index>::~ScoreBucketT()
+{
+}
+
+
+// スコアを初期化（すべての列が候補解に含まれない状態）
+template <typename Index>
+void ScoreBucketT<Index>::initialize(SCPinstanceT<Index> &inst)
+{
+  for (int s = 0; s < maxBucket + 2; s++) HEAD[s] = 0;
+
+  // 各バケットの大きさを数える
+  for (int j = 0; j < nCol; j++)
+  {
+    score[j] = inst.ColWeight[j];
+    HEAD[score[j] + 1]++;
+  }
+  for (int s = 1; s < maxBucket + 2; s++) HEAD[s] += HEAD[s - 1];
+
+  // バケット順に列を並べる（HEAD[s] をずらしながら詰めて最後に戻す）
+  for (int j = 0; j < nCol; j++)
+  {
+    int p = HEAD[score[j]]++;
+    ORDER[p] = j;
+    POS[j] = p;
+  }
+  for (int s = maxBucket + 1; s > 0; s--) HEAD[s] = HEAD[s - 1];
+  HEAD[0] = 0;
+
+  maxScore = maxBucket;
+  while (maxScore > 0 && bucket_size(maxScore) == 0) maxScore--;
+}
+
+
+// ORDER の位置 i と j の列を入れ替える
+template <typename Index>
+void ScoreBucketT<Index>::swap_position(int i, int j)
+{
+  int ci = ORDER[i];
+  int cj = ORDER[j];
+  ORDER[i] = cj;
+  ORDER[j] = ci;
+  POS[cj] = i;
+  POS[ci] = j;
+}
+
+
+// 列cを候補解に追加したときの処理
+template <typename Index>
+void ScoreBucketT<Index>::add_column(int c)
+{
+  if (is_selected(c))
+  {
+    printf("Column %d has already contained in the bucket\n", c);
+    exit(1);
+  }
+
+  // バケット score[c] から候補解の領域まで一つずつ移動
+  for (int s = score[c]; s >= 0; s--)
+  {
+    swap_position(POS[c], HEAD[s]);
+    HEAD[s]++;
+  }
+  score[c] = -score[c];
+
+  while (maxScore > 0 && bucket_size(maxScore) == 0) maxScore--;
+}
+
+
+// 列cを候補解から削除したときの処理
+template <typename Index>
+void ScoreBucketT<Index>::remove_column(int c)
+{
+  if (!is_selected(c))
+  {
+    printf("Column %d is not contained in the bucket\n", c);
+    exit(1);
+  }
+
+  // 候補解の領域からバケット -score[c] まで一つずつ移動
+  score[c] = -score[c];
+  for (int s = 0; s <= score[c]; s++)
+  {
+    swap_position(POS[c], HEAD[s] - 1);
+    HEAD[s]--;
+  }
+
+  if (maxScore < score[c]) maxScore = score[c];
+}
+
+
+// 候補解に含まれない列の中で，スコア最大の列をランダムに一つ返す
+template <typename Index>
+int ScoreBucketT<Index>::get_column_maxscore(std::mt19937_64& rnd)
+{
+  int n = bucket_size(maxScore);
+
+  if (n == 1) return ORDER[HEAD[maxScore]];
+  else return ORDER[HEAD[maxScore] + rnd() % n];
+}
+
+
+// 候補解に含まれない列の中で，スコア最小のもの
+// スコアの小さいバケットから空でないものを探す
+template <typename Index>
+int ScoreBucketT<Index>::min_score() const
+{
+  int s = 0;
+  while (s < maxScore && bucket_size(s) == 0) s++;
+  return s;
+}
+
+
+// 候補解に含まれない列の中で，スコアが閾値以上の列を一様ランダムに一つ返す
+template <typename Index>
+int ScoreBucketT<Index>::get_column_grasp(double alpha, std::mt19937_64& rnd)
+{
+  int minScore = min_score();
+  double threshold = minScore + alpha * (maxScore - minScore);
+
+  // スコアは整数なので，閾値以上のバケットは ceil(threshold) から maxScore まで
+  // （alpha が [0, 1] の外でも，少なくとも maxScore のバケットからは選ぶ）
+  int s = (int)std::ceil(threshold);
+  if (s < minScore) s = minScore;
+  if (s > maxScore) s = maxScore;
+  int n = HEAD[maxScore + 1] - HEAD[s];
+  assert(n > 0);  // 候補解に含まれない列が残っていること
+
+  return ORDER[HEAD[s] + rnd() % n];
+}
+
+
+// 使う幅
+template class ScoreBucketT<uint16_t>;
+template class ScoreBucketT<int>;
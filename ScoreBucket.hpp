@@ -0,0 +1,131 @@
+//---------------------------------------------------------------------------
+// 列のスコアをバケットで管理するクラス
+// スコア最大の列を O(1) で取り出すために使う
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SCPcompact.hpp"
+#include <vector>
+#include <random>
+#include <type_traits>
+
+//
+//
+//  Class ScoreBucket  列のスコアとバケットを管理するクラス
+//
+//  score[j] は，列jが候補解に含まれないときは列jを追加したときに
+//  新たにカバーされる行の数（>= 0），含まれるときは列jを削除したときに
+//  カバーされなくなる行の数にマイナスをつけた値（<= 0）．
+//  行に重みがあるときは行の数の代わりに重みの和．
+//
+//  ORDER は列番号の配列で，前から順に
+//    [0, HEAD[0])          : 候補解に含まれる列
+//    [HEAD[s], HEAD[s+1])  : 候補解に含まれず，スコアが s の列
+//  と並べておく．スコアが1増減するたびに隣のバケットとの境界で
+//  入れ替えるだけなので，更新は O(1) で済む．
+//
+//  列番号と位置は Index 型，スコアは Index と同じ幅の符号付き整数で持つ．
+//
+template <typename Index>
+class ScoreBucketT
+{
+ public:
+  typedef typename std::make_signed<Index>::type Score;
+
+  int nCol;                     // 列数
+  int maxBucket;                // スコアの上限（列がカバーする行の重みの和の最大値）
+  int maxScore;                 // 空でないバケットのうちスコア最大のもの
+
+  std::vector<Score> score;     // score[j]: 列jのスコア
+  std::vector<Index> ORDER;     // バケット順に並べた列番号
+  std::vector<Index> POS;       // POS[j]: 列jの ORDER 中の位置
+  std::vector<Index> HEAD;      // HEAD[s]: スコア s のバケットの先頭位置
+
+ public:
+  ScoreBucketT(SCPinstanceT<Index> &inst);
+  ~ScoreBucketT();
+
+  // スコアを初期化（すべての列が候補解に含まれない状態）
+  void initialize(SCPinstanceT<Index> &inst);
+
+  int operator[](int c) const { return score[c]; }
+
+  // 列cが候補解に含まれているか
+  bool is_selected(int c) const { return POS[c] < HEAD[0]; }
+
+  // 列cのスコアを1増やす
+  // スコアの更新は内側のループから呼ばれるのでインラインで定義する
+  void increase(int c)
+  {
+    int s = score[c]++;
+    int p = POS[c];
+    if (p < HEAD[0]) return;    // 候補解に含まれる列はバケットに入っていない
+
+    // バケット s の末尾と入れ替えて，バケット s+1 の先頭にする
+    int q = --HEAD[s + 1];
+    int d = ORDER[q];
+    ORDER[p] = d;  POS[d] = p;
+    ORDER[q] = c;  POS[c] = q;
+
+    if (maxScore <= s) maxScore = s + 1;
+  }
+
+  // 列cのスコアを1減らす
+  void decrease(int c)
+  {
+    int s = score[c]--;
+    int p = POS[c];
+    if (p < HEAD[0]) return;
+
+    // バケット s の先頭と入れ替えて，バケット s-1 の末尾にする
+    int q = HEAD[s]++;
+    int d = ORDER[q];
+    ORDER[p] = d;  POS[d] = p;
+    ORDER[q] = c;  POS[c] = q;
+
+    if (maxScore == s && HEAD[s] == HEAD[s + 1]) maxScore--;
+  }
+
+  // 列cのスコアを w（>= 1）増やす・減らす（重み w の行のとき）
+  // バケットを1つずつ移るので O(w)．ほとんどの行は w = 1 なので1回目はループの外で行う
+  void increase(int c, int w)
+  {
+    increase(c);
+    for (int i = 1; i < w; i++) increase(c);
+  }
+  void decrease(int c, int w)
+  {
+    decrease(c);
+    for (int i = 1; i < w; i++) decrease(c);
+  }
+
+  // 列cを候補解に追加したときの処理（スコアの符号を反転）
+  void add_column(int c);
+
+  // 列cを候補解から削除したときの処理（スコアの符号を反転）
+  void remove_column(int c);
+
+  // 候補解に含まれない列のうちスコア s の列の数
+  int bucket_size(int s) const { return HEAD[s + 1] - HEAD[s]; }
+
+  // スコア s のバケットの i 番目の列
+  int bucket_column(int s, int i) const { return ORDER[HEAD[s] + i]; }
+
+  // 候補解に含まれない列の中で，スコア最大の列をランダムに一つ返す
+  int get_column_maxscore(std::mt19937_64& rnd);
+
+  // 候補解に含まれない列の中で，スコア最小のもの
+  int min_score() const;
+
+  // 候補解に含まれない列の中で，スコアが
+  //   min + alpha * (max - min)
+  // 以上の列から一様ランダムに一つ返す（GRASP の制限付き候補リスト）
+  // 閾値以上の列は ORDER の末尾に連続して並んでいるので，数えずに選べる
+  // （0 <= alpha <= 1．候補解に含まれない列が1列もないときは呼ばないこと）
+  int get_column_grasp(double alpha, std::mt19937_64& rnd);
+
+ private:
+  // ORDER の位置 i と j の列を入れ替える
+  void swap_position(int i, int j);
+};
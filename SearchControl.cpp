@@ -0,0 +1,63 @@
+#include "SearchControl.hpp"
+#include <vector>
+
+//
+//
+//  Class SearchControl
+//
+//
+
+// コンストラクタ
+SearchControl::SearchControl()
+  : hasDeadline(false), Target(0), UpperBound(INT_MAX), Stopped(false), GlobalBest(0), Iterations(0), Moves(0)
+{
+  Start = Clock::now();
+
+  // 改善の記録で探索中に確保し直さないように（改善の回数は行数以下）
+  Trajectory.reserve(256);
+}
+
+
+// 時間制限（ミリ秒）を設定する
+void SearchControl::set_time_limit(double ms)
+{
+  hasDeadline = true;
+  Deadline = Start + std::chrono::duration_cast<Clock::duration>(
+    std::chrono::duration<double, std::milli>(ms));
+}
+
+
+// 開始からの経過時間（ミリ秒）
+double SearchControl::elapsed_ms() const
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+
+// 結果 slot の最良解のカバー数が num_Cover になったことを知らせる
+void SearchControl::report(int num_Cover, int slot, long iteration)
+{
+  uint64_t key = ((uint64_t)num_Cover << 32) | (uint32_t)(~slot);
+  uint64_t cur = GlobalBest.load(std::memory_order_relaxed);
+  while (cur < key && !GlobalBest.compare_exchange_weak(cur, key, std::memory_order_relaxed)) {}
+
+  // カバー数が増えたときだけ記録する（同じカバー数で番号だけ変わったときは記録しない）
+  if ((int)(cur >> 32) < num_Cover)
+  {
+    std::lock_guard<std::mutex> lock(LogMutex);
+    Improvement imp = { elapsed_ms(), iteration, num_Cover };
+    Trajectory.push_back(imp);
+  }
+
+  if (Target > 0 && num_Cover >= Target) Stopped.store(true, std::memory_order_relaxed);
+  if (num_Cover >= UpperBound.load()) Stopped.store(true, std::memory_order_relaxed);
+}
+
+
+// 最適値の上界を知らせる
+void SearchControl::set_upper_bound(int ub)
+{
+  int cur = UpperBound.load();
+  while (ub < cur && !UpperBound.compare_exchange_weak(cur, ub)) {}
+  if (best_cover() >= UpperBound.load()) Stopped.store(true, std::memory_order_relaxed);
+}
@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------
+// 探索の打ち切り（時間制限・目標値）と最良解の記録を管理するクラス
+// 複数のスレッドから共有して使う
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <climits>
+
+// 最良解が更新されたときの記録
+struct Improvement
+{
+  double time_ms;               // 開始からの経過時間（ミリ秒）
+  long   iteration;             // それまでに始めた GRASP の反復の数（全スレッドの合計）
+  int    num_Cover;             // 更新後のカバー数
+};
+
+
+//
+//
+//  Class SearchControl
+//
+//  全スレッドの最良解は GlobalBest に，上位32ビットに num_Cover，
+//  下位32ビットに（反転した）結果の番号を詰めて CAS で最大値を更新する．
+//  カバー数が同じときは番号の小さい結果が勝つので，スレッドの実行順によらず
+//  同じ結果が選ばれる．
+//
+class SearchControl
+{
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  Clock::time_point Start;      // 開始時刻
+  Clock::time_point Deadline;   // 打ち切る時刻（hasDeadline のときだけ有効）
+  bool hasDeadline;
+  int  Target;                  // このカバー数に達したら打ち切る（0 なら打ち切らない）
+  std::atomic<int> UpperBound;  // 最適値の上界．最良解がこれに達したら打ち切る（既定 INT_MAX）
+
+  std::atomic<bool> Stopped;    // 打ち切ったか
+  std::atomic<uint64_t> GlobalBest;
+  std::atomic<long> Iterations; // 始めた反復の数
+  std::atomic<long> Moves;      // 局所探索で評価した交換 (c1, c2) の候補の数
+
+  std::mutex LogMutex;
+  std::vector<Improvement> Trajectory; // 最良のカバー数が増えたときの記録
+
+ public:
+  SearchControl();
+
+  // 時間制限（ミリ秒）を設定する．制限は Start から数える
+  void set_time_limit(double ms);
+
+  // 開始からの経過時間（ミリ秒）
+  double elapsed_ms() const;
+
+  // 打ち切るべきか（時間を見るのは steady_clock を1回読むだけ）
+  bool should_stop()
+  {
+    if (Stopped.load(std::memory_order_relaxed)) return true;
+    if (hasDeadline && Clock::now() >= Deadline)
+    {
+      Stopped.store(true, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  }
+
+  // 反復を一つ始める．全体で何番目の反復かを返す（1から）
+  long next_iteration() { return Iterations.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+  // 局所探索で n 回の交換を評価した
+  void add_moves(long n) { Moves.fetch_add(n, std::memory_order_relaxed); }
+
+  // 結果 slot の最良解のカバー数が num_Cover になったことを知らせる
+  void report(int num_Cover, int slot, long iteration);
+
+  // 全体の最良解の番号とカバー数
+  int best_slot() const { return ~(uint32_t)GlobalBest.load(); }
+  int best_cover() const { return GlobalBest.load() >> 32; }
+
+  // 最適値の上界を知らせる（小さくなるときだけ更新する）．最良解がもう達していれば打ち切る
+  void set_upper_bound(int ub);
+
+  // 目標値に達して打ち切ったか
+  bool reached_target() const { return Target > 0 && best_cover() >= Target; }
+
+  // 上界に達して（最適解が見つかって）打ち切ったか
+  bool reached_bound() const { return best_cover() >= UpperBound.load(); }
+};
@@ -0,0 +1,92 @@
+#include "Solver.hpp"
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+//
+//
+//  Class SCPsolver
+//
+//
+
+// コンストラクタ（ファイルから）
+SCPsolver::SCPsolver(const char *FileName, const SCPsolverOptions &opt)
+  : Options(opt), Inst(FileName), Bits(NULL), List(NULL)
+{
+  setup();
+}
+
+
+// コンストラクタ（列のリストから）
+SCPsolver::SCPsolver(int nRows, const std::vector<std::vector<int>> &Columns,
+                     const SCPsolverOptions &opt)
+  : Options(opt), Inst(nRows, Columns), Bits(NULL), List(NULL)
+{
+  setup();
+}
+
+
+// デストラクタ
+SCPsolver::~SCPsolver()
+{
+  for (SearchWorkspaces *ws : Free) delete ws;
+  delete Bits;
+  delete List;
+}
+
+
+// 探索用のインスタンスを作る
+void SCPsolver::setup()
+{
+  if (Options.nthreads < 1 || Options.nelite < 0 || Options.alpha < 0 || Options.alpha > 1 ||
+      (Options.bitset && (Options.nelite > 0 || Options.reorder)) ||
+      (!Options.bitset && Options.construction == CONSTRUCT_LAZY))
+    throw DataException();
+
+  if (Options.bitset) Bits = new SCPbitinstance(Inst);
+  else List = new ListInstance(Inst, select_width(Inst), false, 0, Options.reorder);
+}
+
+
+// K 列を選んで解く
+SCPsolveResult SCPsolver::solve(int K, long budget, uint64_t seed, double timeLimit)
+{
+  if (K < 1 || K > Inst.numColumns || (budget <= 0 && timeLimit <= 0)) throw DataException();
+
+  // 空いている作業領域を取る（なければ作る）
+  SearchWorkspaces *ws;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (Free.empty()) ws = new SearchWorkspaces();
+    else
+    {
+      ws = Free.back();
+      Free.pop_back();
+    }
+  }
+
+  SearchControl ctl;
+  int niter = (budget <= 0) ? INT_MAX : (int)std::min(budget, (long)INT_MAX);
+  if (timeLimit > 0) ctl.set_time_limit(timeLimit);
+
+  int nthreads = Options.nthreads;
+  std::vector<SCPsolution> Result(nthreads, SCPsolution(Inst, K));
+  int best = parallel_grasp_neighborhood_search(Inst, Bits, List, K, Options.alpha, niter, 1,
+                                                nthreads, seed, Result, ctl, NULL,
+                                                Options.nelite, Options.construction, NULL, ws);
+
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    Free.push_back(ws);
+  }
+
+  SCPsolveResult res;
+  res.num_Cover = Result[best].num_Cover;
+  for (int c : Result[best].CS)
+  {
+    if (c < Inst.numColumns) res.Columns.push_back(c);
+  }
+  res.Iterations = ctl.Iterations.load();
+  res.ElapsedMs = ctl.elapsed_ms();
+  return res;
+}
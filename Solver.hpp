@@ -0,0 +1,84 @@
+//---------------------------------------------------------------------------
+// 最大 k 被覆問題のソルバ（ライブラリ libmaxkcover の C++ の入口）
+// インスタンスを1回だけ読み，K や乱数の種を変えて何度でも解く．
+// C から使うときは maxkcover.h を使う
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SCPv.hpp"
+#include "SCPbitset.hpp"
+#include "rnkc.hpp"
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+// ソルバの設定（rnkc_main のオプションと同じ意味）
+struct SCPsolverOptions
+{
+  int nthreads;                 // 1回の solve で使うスレッドの数
+  double alpha;                 // GRASP の alpha
+  int nelite;                   // エリート解のプールの大きさ（リスト版のみ）
+  SCPconstruction construction; // 初期解を作る方法
+  bool bitset;                  // ビット集合版で解く
+  bool reorder;                 // 行と列の番号を付け替える（リスト版のみ）
+
+  SCPsolverOptions()
+    : nthreads(1), alpha(0.85), nelite(0), construction(CONSTRUCT_GRASP),
+      bitset(false), reorder(false) {}
+};
+
+// solve の結果
+struct SCPsolveResult
+{
+  int num_Cover;                // カバー数
+  std::vector<int> Columns;     // 選んだ列（0 から数えた列番号，昇順）
+  long Iterations;              // GRASP の反復の数
+  double ElapsedMs;             // かかった時間（ミリ秒）
+};
+
+
+//
+//
+//  Class SCPsolver
+//
+//  インスタンスと探索用のインスタンス（リスト版かビット集合版）は作った後は変えないので，
+//  複数のスレッドから同時に solve を呼んでよい．スレッドごとの作業領域（SearchWorkspaces）は
+//  呼び出しが終わったら残しておき，次の呼び出しで使い回す（同じ K なら確保し直さない）．
+//  設定やインスタンスが正しくなければ DataException を投げる．
+//
+class SCPsolver
+{
+ public:
+  SCPsolverOptions Options;
+  SCPinstance Inst;
+
+ public:
+  // ファイル（OR-Library のテキスト形式か scp2bin のバイナリ形式）から読む
+  SCPsolver(const char *FileName, const SCPsolverOptions &opt = SCPsolverOptions());
+
+  // 列のリストから作る（Columns[j] は列 j がカバーする行，0 から nRows-1）
+  SCPsolver(int nRows, const std::vector<std::vector<int>> &Columns,
+            const SCPsolverOptions &opt = SCPsolverOptions());
+
+  ~SCPsolver();
+  SCPsolver(const SCPsolver&) = delete;
+  SCPsolver& operator=(const SCPsolver&) = delete;
+
+  int numRows() const { return Inst.numRows; }
+  int numColumns() const { return Inst.numColumns; }
+
+  // K 列を選んで解く．budget は GRASP の反復回数（0 以下なら制限なし），
+  // timeLimit はミリ秒（0 以下なら制限なし）．どちらも制限なしにはできない．
+  // seed とスレッド数が同じなら同じ結果になる
+  SCPsolveResult solve(int K, long budget, uint64_t seed, double timeLimit = 0);
+
+ private:
+  SCPbitinstance *Bits;         // ビット集合版のインスタンス（bitset のとき）
+  ListInstance *List;           // リスト版のインスタンス（そうでないとき）
+  std::mutex Mutex;
+  std::vector<SearchWorkspaces*> Free; // 使っていない作業領域
+
+  // 探索用のインスタンスを作る
+  void setup();
+};
@@ -0,0 +1,45 @@
+/*---------------------------------------------------------------------------
+ * libmaxkcover の C の入口（SCPsolver の薄い包み）
+ * インスタンスを1回だけ読み，同じプロセスの中で K や乱数の種を変えて何度でも解く．
+ * 列番号は全て 0 から数える．失敗したときは（ソルバの中の例外も含めて）NULL か -1 を返す．
+ * 1つのソルバの maxkcover_solve は複数のスレッドから同時に呼んでよい．
+ * Araki
+ *---------------------------------------------------------------------------*/
+#ifndef MAXKCOVER_H
+#define MAXKCOVER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct maxkcover_solver maxkcover_solver;
+
+/* ファイル（OR-Library のテキスト形式か scp2bin のバイナリ形式）から読む．
+   nthreads は1回の solve で使うスレッドの数 */
+maxkcover_solver *maxkcover_load(const char *path, int nthreads);
+
+/* 列ごとの行のリスト（CSR 形式）から作る．列 j がカバーする行は
+   col_rows[col_start[j]] .. col_rows[col_start[j+1]-1]（0 から nrows-1）．
+   col_start[0] は 0 で，col_start は減らないこと（そうでなければ NULL を返す） */
+maxkcover_solver *maxkcover_create(int nrows, int ncols, const int *col_start,
+                                   const int *col_rows, int nthreads);
+
+void maxkcover_free(maxkcover_solver *s);
+
+/* s が NULL なら -1 */
+int maxkcover_num_rows(const maxkcover_solver *s);
+int maxkcover_num_columns(const maxkcover_solver *s);
+
+/* K 列を選んで解く．budget は GRASP の反復回数（0 以下なら制限なし），
+   time_limit_ms はミリ秒（0 以下なら制限なし．どちらか一方は必要）．
+   columns が NULL でなければ選んだ K 列を昇順に入れる．戻り値はカバー数 */
+int maxkcover_solve(maxkcover_solver *s, int k, long budget, uint64_t seed,
+                    double time_limit_ms, int *columns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
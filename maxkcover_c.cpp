@@ -0,0 +1,92 @@
+#include "maxkcover.h"
+#include "Solver.hpp"
+#include <vector>
+
+// C から見えるソルバ
+// C の関数からは例外を外に出さない（DataException も std::system_error なども，NULL か -1 を返す）
+struct maxkcover_solver
+{
+  SCPsolver solver;
+
+  maxkcover_solver(const char *path, const SCPsolverOptions &opt)
+    : solver(path, opt) {}
+  maxkcover_solver(int nrows, const std::vector<std::vector<int>> &cols, const SCPsolverOptions &opt)
+    : solver(nrows, cols, opt) {}
+};
+
+
+// ファイルから読む
+maxkcover_solver *maxkcover_load(const char *path, int nthreads)
+{
+  SCPsolverOptions opt;
+  opt.nthreads = nthreads;
+  try
+  {
+    return new maxkcover_solver(path, opt);
+  }
+  catch (...) {}
+  return NULL;
+}
+
+
+// CSR 形式の列のリストから作る
+maxkcover_solver *maxkcover_create(int nrows, int ncols, const int *col_start,
+                                   const int *col_rows, int nthreads)
+{
+  if (nrows < 0 || ncols < 0 || col_start == NULL || col_start[0] != 0 ||
+      (col_rows == NULL && col_start[ncols] > 0))
+    return NULL;
+  SCPsolverOptions opt;
+  opt.nthreads = nthreads;
+  try
+  {
+    std::vector<std::vector<int>> cols(ncols);
+    for (int j = 0; j < ncols; j++)
+    {
+      if (col_start[j + 1] < col_start[j]) return NULL;
+      cols[j].assign(col_rows + col_start[j], col_rows + col_start[j + 1]);
+    }
+    return new maxkcover_solver(nrows, cols, opt);
+  }
+  catch (...) {}
+  return NULL;
+}
+
+
+void maxkcover_free(maxkcover_solver *s)
+{
+  delete s;
+}
+
+
+int maxkcover_num_rows(const maxkcover_solver *s)
+{
+  if (s == NULL) return -1;
+  return s->solver.numRows();
+}
+
+
+int maxkcover_num_columns(const maxkcover_solver *s)
+{
+  if (s == NULL) return -1;
+  return s->solver.numColumns();
+}
+
+
+// K 列を選んで解く
+int maxkcover_solve(maxkcover_solver *s, int k, long budget, uint64_t seed,
+                    double time_limit_ms, int *columns)
+{
+  if (s == NULL) return -1;
+  try
+  {
+    SCPsolveResult res = s->solver.solve(k, budget, seed, time_limit_ms);
+    if (columns != NULL)
+    {
+      for (size_t i = 0; i < res.Columns.size(); i++) columns[i] = res.Columns[i];
+    }
+    return res.num_Cover;
+  }
+  catch (...) {}
+  return -1;
+}
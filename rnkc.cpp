@@ -0,0 +1,1205 @@
+#include "rnkc.hpp"
+#include "Profile.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <sstream>
+#include <cstdint>
+using namespace std;
+
+
+// 解csがカバーする要素数を返す
+int check_number_of_covered_elements(SCPinstance& inst,
+                                     SCPsolution& cs)
+{
+  int cov = 0;
+  vector<int> covered(inst.numRows, 0);
+  for (int c : cs.CS)
+  {
+    if (c > inst.numColumns) continue;
+    for (int r : inst.ColEntries[c])
+    {
+      covered[r]++;
+    }
+  }
+
+  for (int r = 0; r < inst.numRows; r++)
+  {
+    if (cs.COVERED[r] == covered[r] && covered[r] > 0) cov++;
+    else if (cs.COVERED[r] != covered[r])
+    {
+      printf("cs.COVERED[%d] = %d but covered[%d] = %d\n", r, cs.COVERED[r], r, covered[r]);
+    }
+  }
+
+  if (cov == cs.num_Cover) return cov;
+  else
+  {
+    printf("The candidate solution covers %d elements, but our program coveres %d elements\n", cov, cs.num_Cover);
+    exit(1);
+  }
+}
+
+
+
+// 解 from の列を足し引きして，列数 to.K の解 to を作る
+void resize_solution(SCPinstance& inst,
+                     SCPsolution& from,
+                     SCPsolution& to)
+{
+  // 足し引きの途中は from と to の大きい方の列数で持つ
+  SCPsolution cs(inst, max(from.K, to.K));
+  int n = 0;
+  for (int c : from.CS)
+  {
+    if (c >= inst.numColumns) continue;
+    cs.add_column(inst, c);
+    n++;
+  }
+
+  // 多すぎる列は，カバーされなくなる行が最小の列から除く
+  while (n > to.K)
+  {
+    int minc = -1, minLoss = inst.numRows + 1;
+    for (int c : cs.CS)
+    {
+      if (c >= inst.numColumns) continue;
+      int loss = 0;
+      for (int r : inst.ColEntries[c]) if (cs.COVERED[r] == 1) loss++;
+      if (loss < minLoss) { minLoss = loss; minc = c; }
+    }
+    cs.remove_column(inst, minc);
+    n--;
+  }
+
+  // 足りない列は，新たにカバーする行が最大の列を足す
+  while (n < to.K)
+  {
+    int maxc = -1, maxGain = -1;
+    for (int c = 0; c < inst.numColumns; c++)
+    {
+      if (cs.SOLUTION[c]) continue;
+      int gain = 0;
+      for (int r : inst.ColEntries[c]) if (cs.COVERED[r] == 0) gain++;
+      if (gain > maxGain) { maxGain = gain; maxc = c; }
+    }
+    cs.add_column(inst, maxc);
+    n++;
+  }
+
+  to.initialize(inst);
+  for (int c : cs.CS)
+  {
+    if (c < inst.numColumns) to.add_column(inst, c);
+  }
+}
+
+
+// ファイルから解を読む
+int read_solution(SCPinstance& inst,
+                  const char* FileName,
+                  SCPsolution& to)
+{
+  FILE *fp = fopen(FileName, "r");
+  if (fp == NULL) throw DataException();
+
+  vector<int> cols;
+  vector<char> seen(inst.numColumns, 0);
+  int skipped = 0;
+  int c, n;
+  while ((n = fscanf(fp, "%d", &c)) == 1)
+  {
+    c--;                        // ファイルの列番号は1から
+    if (c < 0 || c >= inst.numColumns || seen[c]) { skipped++; continue; }
+    seen[c] = 1;
+    cols.push_back(c);
+  }
+  fclose(fp);
+  if (n != EOF) throw DataException();
+
+  SCPsolution from(inst, max(1, (int)cols.size()));
+  for (int j : cols) from.add_column(inst, j);
+  resize_solution(inst, from, to);
+  return skipped;
+}
+
+
+// 解 cs の列番号をファイルに書く
+bool write_solution(const char* FileName,
+                    SCPsolution& cs)
+{
+  FILE *fp = fopen(FileName, "w");
+  if (fp == NULL) return false;
+  for (int c : cs.CS)
+  {
+    if (c < cs.nCol) fprintf(fp, "%d ", c + 1);
+  }
+  fprintf(fp, "\n");
+  return fclose(fp) == 0;
+}
+
+
+
+// 列cを解に追加したときのscoreの更新
+template <typename Index, typename Counter>
+void add_update_score(SCPinstanceT<Index>& inst,
+                      SCPsolutionT<Index, Counter>& cs,
+                      int c,
+                      ScoreBucketT<Index>& score)
+{
+  PROF_CALL(PROF_ADD_UPDATE_SCORE, inst.ColEntries[c].size());
+  score.add_column(c);
+  // スコア更新
+  for (int r : inst.ColEntries[c]) // 列cがカバーする行
+  {
+    int w = inst.RowWeight[r];
+    // r行が初めてカバーされたら，rを含む行のスコアを減少
+    if (cs.COVERED[r] == 1)
+    {
+      PROF_ENTRIES(PROF_ADD_UPDATE_SCORE, inst.RowCovers[r].size());
+      PROF_SCORES(PROF_ADD_UPDATE_SCORE, inst.RowCovers[r].size() - 1);
+      for (int rc : inst.RowCovers[r])
+      {
+        if (rc != c) score.decrease(rc, w);
+      } // End: for ri
+    } // End if covered[r] == 1
+
+    // r行が2回カバーされたら，rを含むCSの要素のスコアを増加
+    if (cs.COVERED[r] == 2)
+    {
+      for (int rc : inst.RowCovers[r]) // r行をカバーする列
+      {
+        PROF_ENTRIES(PROF_ADD_UPDATE_SCORE, 1);
+        if (cs.is_selected(rc) && rc != c)
+        {
+          PROF_SCORES(PROF_ADD_UPDATE_SCORE, 1);
+          score.increase(rc, w);
+          break;
+        }
+      }
+    } // End if covered[r] == 2
+  }
+}
+
+
+// 列cを解に追加したときのscoreの更新
+template <typename Index, typename Counter>
+void remove_update_score(SCPinstanceT<Index>& inst,
+                         SCPsolutionT<Index, Counter>& cs,
+                         int c,
+                         ScoreBucketT<Index>& score)
+{
+  PROF_CALL(PROF_REMOVE_UPDATE_SCORE, inst.ColEntries[c].size());
+  score.remove_column(c);
+
+  // スコア更新
+  for (int r : inst.ColEntries[c]) // 列cがカバーする行
+  {
+    int w = inst.RowWeight[r];
+    // r行がカバーされなくなったら，rを含む行のスコアを増加
+    if (cs.COVERED[r] == 0)
+    {
+      PROF_ENTRIES(PROF_REMOVE_UPDATE_SCORE, inst.RowCovers[r].size());
+      PROF_SCORES(PROF_REMOVE_UPDATE_SCORE, inst.RowCovers[r].size() - 1);
+      for (int rc : inst.RowCovers[r]) // r行をカバーする列
+      {
+        if (rc != c) score.increase(rc, w);
+      } // End: for ri
+    } // End if covered[r] == 0
+
+    // r行が1回カバーされたら，rを含むCSの要素のスコアを減少
+    if (cs.COVERED[r] == 1)
+    {
+      for (int rc : inst.RowCovers[r]) // r行をカバーする列
+      {
+        PROF_ENTRIES(PROF_REMOVE_UPDATE_SCORE, 1);
+        if (cs.is_selected(rc))
+        {
+          PROF_SCORES(PROF_REMOVE_UPDATE_SCORE, 1);
+          score.decrease(rc, w);
+          break;
+        }
+      }
+    } // End if covered[r] == 1
+  }
+}
+
+
+// 候補解csに含まれてない中で，スコア最大の列を返す
+// スコア最大のバケットから一様ランダムに選ぶ
+template <typename Index, typename Counter>
+int get_column_maxscore(SCPinstanceT<Index>& inst,
+                        SCPsolutionT<Index, Counter>& CS,
+                        ScoreBucketT<Index>& score,
+                        mt19937_64& rnd)
+{
+  PROF_CALL(PROF_GET_COLUMN_MAXSCORE, 1);
+  return score.get_column_maxscore(rnd);
+}
+
+
+// 候補解csに含まれてない中で，スコアが alpha で決まる閾値以上の列をランダムに返す
+// 閾値以上のバケットから一様ランダムに選ぶ（最大・最小は候補解に含まれない列だけで決める）
+template <typename Index, typename Counter>
+int get_column_grasp(SCPinstanceT<Index>& inst,
+                     SCPsolutionT<Index, Counter>& CS,
+                     ScoreBucketT<Index>& score,
+                     double alpha,
+                     mt19937_64& rnd)
+{
+  PROF_CALL(PROF_GET_COLUMN_GRASP, 1);
+  return score.get_column_grasp(alpha, rnd);
+}
+
+
+
+// 貪欲法：スコア最大の列をK列選ぶ
+// 引数の cs に結果が入る
+template <typename Index, typename Counter>
+void greedy_construction(SCPinstanceT<Index>& inst,
+                         SCPsolutionT<Index, Counter>& cs,
+                         ScoreBucketT<Index>& score,
+                         mt19937_64& rnd)
+{
+  PROF_PHASE(PHASE_CONSTRUCTION);
+  int maxc;
+
+  cs.initialize(inst);
+  for (int k = 0; k < cs.K; k++)
+  {
+    maxc = get_column_maxscore(inst, cs, score, rnd);
+    cs.add_column(inst, maxc);
+    // スコアの更新
+    add_update_score(inst, cs, maxc, score);
+  } // End for k
+}
+
+
+// GRASP法：スコアが alpha * (最大値 - 最小値) 以上である列からランダムに一つ選ぶ
+template <typename Index, typename Counter>
+void grasp_construction(SCPinstanceT<Index>& inst,
+                        SCPsolutionT<Index, Counter>& cs,
+                        ScoreBucketT<Index>& score,
+                        double alpha,
+                        mt19937_64& rnd)
+{
+  PROF_PHASE(PHASE_CONSTRUCTION);
+  int c;
+  cs.initialize(inst);
+  for (int k = 0; k < cs.K; k++)
+  {
+    c = get_column_grasp(inst, cs, score, alpha, rnd);
+    cs.add_column(inst, c);
+    add_update_score(inst, cs, c, score);
+  } // End for k
+}
+
+
+// 列outを削除して列inを追加したときの num_Cover の変化量（状態は変えない）
+// out だけがカバーしている行のうち in もカバーする行は，削除しても in でカバーし直される
+template <typename Index, typename Counter>
+int swap_delta(SCPinstanceT<Index>& inst,
+               SCPsolutionT<Index, Counter>& cs,
+               ScoreBucketT<Index>& score,
+               int out,
+               int in)
+{
+  if (in == out) return 0;
+
+  int overlap = 0;
+  IndexListT<Index> oc = inst.ColEntries[out];
+  for (int r : inst.ColEntries[in])
+  {
+    if (cs.COVERED[r] == 1 && binary_search(oc.begin(), oc.end(), r)) overlap += inst.RowWeight[r];
+  }
+
+  return score[in] + overlap + score[out]; // score[out] = -(outの削除でカバーされなくなる行の数)
+}
+
+
+// 列outを削除したときに，代わりに追加するとカバー数が最大になる列を返す（状態は変えない）
+// 候補には out 自身も含み，同点の列からは一様ランダムに選ぶ．
+// delta にそのときの num_Cover の変化量が入る（out を選べば 0 なので，delta >= 0）．
+// nEval には交換先の候補として値を比べた列の数（加点された列と最大スコアのバケットの列）を足す．
+template <typename Index, typename Counter>
+int best_swap_column(SCPinstanceT<Index>& inst,
+                     SCPsolutionT<Index, Counter>& cs,
+                     ScoreBucketT<Index>& score,
+                     int out,
+                     SwapWorkspaceT<Index>& ws,
+                     mt19937_64& rnd,
+                     int& delta,
+                     long& nEval)
+{
+  PROF_CALL(PROF_BEST_SWAP, inst.ColEntries[out].size());
+
+  // out だけがカバーしている行をカバーする列に加点
+  ws.touched.clear();
+  for (int r : inst.ColEntries[out])
+  {
+    if (cs.COVERED[r] != 1) continue;
+    PROF_ENTRIES(PROF_BEST_SWAP, inst.RowCovers[r].size());
+    int w = inst.RowWeight[r];
+    for (int rc : inst.RowCovers[r])
+    {
+      if (ws.bonus[rc] == 0) ws.touched.push_back(rc);
+      ws.bonus[rc] += w;
+    }
+  }
+  if (ws.bonus[out] == 0) ws.touched.push_back(out);
+
+  // 加点された列の値は score + bonus（out は削除後のスコア = bonus）．
+  // それ以外の列の最大値は score.maxScore で，そのバケットには加点された列は入らない．
+  int best = score.maxScore;
+  for (int c : ws.touched)
+  {
+    int v = (c == out) ? ws.bonus[c] : score[c] + ws.bonus[c];
+    if (best < v) best = v;
+  }
+
+  int nBucket = (best == score.maxScore) ? score.bucket_size(best) : 0;
+  nEval += (long)ws.touched.size() + nBucket;
+  int nTie = 0;
+  for (int c : ws.touched)
+  {
+    int v = (c == out) ? ws.bonus[c] : score[c] + ws.bonus[c];
+    if (v == best) ws.touched[nTie++] = c;  // 同点の列を先頭に詰める（以降は bonus を消すだけ）
+    else ws.bonus[c] = 0;
+  }
+  for (int i = 0; i < nTie; i++) ws.bonus[ws.touched[i]] = 0;
+
+  int j = (nBucket + nTie == 1) ? 0 : rnd() % (nBucket + nTie);
+  delta = best + score[out];
+
+  if (j < nBucket) return score.bucket_column(best, j);
+  else return ws.touched[j - nBucket];
+}
+
+
+// 単純な改善法
+// 各列 c1 について，c1 と交換するのが最もよい列 c2 を差分で評価し，
+// カバー数が減らない（c2 != c1 の）ときだけ実際に交換する
+// 引数の cs に結果が入る．戻り値は評価した (c1, c2) の交換の数
+template <typename Index, typename Counter>
+long simple_neighborhood_search(SCPinstanceT<Index>& inst,
+                                SCPsolutionT<Index, Counter>& cs,
+                                ScoreBucketT<Index>& score,
+                                SwapWorkspaceT<Index>& ws,
+                                mt19937_64& rnd)
+{
+  PROF_PHASE(PHASE_LOCAL_SEARCH);
+  int K = cs.K;
+  int c1, c2, delta;
+  long nEval = 0;
+
+  vector<Index>& idx = ws.order;
+  idx.assign(cs.CS.begin(), cs.CS.end());
+  random_permutation(idx, rnd);
+
+  for (int i = 0; i < K; ++i)
+  {
+    c1 = idx[i];
+
+    // 最大スコアの列
+    c2 = best_swap_column(inst, cs, score, c1, ws, rnd, delta, nEval);
+    if (c2 == c1 || delta < 0) continue;
+
+    cs.remove_column(inst, c1);
+    remove_update_score(inst, cs, c1, score);
+    cs.add_column(inst, c2);
+    add_update_score(inst, cs, c2, score);
+  } // End for i
+
+  return nEval;
+}
+
+
+// 解 cs から解 guide へ1列ずつ交換しながら近づく（path relinking）
+// 各ステップでは，guide にだけある列のうちスコア最大の列 in を加え，cs にだけある列のうち
+// in と交換したときにカバー数が最大になる列を除く（スコアは差分で更新する）．
+// guide の1列手前まで進んだら，途中でカバー数が最大だった解（cs より大きいときだけ）まで
+// 交換を逆にたどって戻す．
+template <typename Index, typename Counter>
+int path_relinking(SCPinstanceT<Index>& inst,
+                   SCPsolutionT<Index, Counter>& cs,
+                   ScoreBucketT<Index>& score,
+                   const vector<Index>& guide,
+                   RelinkWorkspaceT<Index>& ws)
+{
+  PROF_PHASE(PHASE_PATH_RELINKING);
+
+  // 加える列と除く列
+  ws.cols.assign(cs.CS.begin(), cs.CS.end());
+  sort(ws.cols.begin(), ws.cols.end());
+  ws.in.clear();
+  ws.out.clear();
+  set_difference(guide.begin(), guide.end(), ws.cols.begin(), ws.cols.end(), back_inserter(ws.in));
+  set_difference(ws.cols.begin(), ws.cols.end(), guide.begin(), guide.end(), back_inserter(ws.out));
+
+  int d = ws.in.size();
+  if (d < 2) return 0;          // 途中の解がない
+
+  int bestCover = cs.num_Cover;
+  int bestStep = 0;
+  ws.pathIn.clear();
+  ws.pathOut.clear();
+  for (int step = 1; step < d; step++)
+  {
+    // 加える列：スコア最大
+    int bi = 0;
+    for (int i = 1; i < (int)ws.in.size(); i++)
+    {
+      if (score[ws.in[i]] > score[ws.in[bi]]) bi = i;
+    }
+    int cadd = ws.in[bi];
+
+    // 除く列：cadd と交換したときのカバー数の変化が最大
+    int bo = 0;
+    int bestDelta = swap_delta(inst, cs, score, ws.out[0], cadd);
+    for (int o = 1; o < (int)ws.out.size(); o++)
+    {
+      int delta = swap_delta(inst, cs, score, ws.out[o], cadd);
+      if (bestDelta < delta)
+      {
+        bestDelta = delta;
+        bo = o;
+      }
+    }
+    int cdel = ws.out[bo];
+
+    cs.remove_column(inst, cdel);
+    remove_update_score(inst, cs, cdel, score);
+    cs.add_column(inst, cadd);
+    add_update_score(inst, cs, cadd, score);
+
+    ws.in[bi] = ws.in.back();  ws.in.pop_back();
+    ws.out[bo] = ws.out.back(); ws.out.pop_back();
+    ws.pathIn.push_back(cadd);
+    ws.pathOut.push_back(cdel);
+
+    if (bestCover < cs.num_Cover)
+    {
+      bestCover = cs.num_Cover;
+      bestStep = step;
+    }
+  } // End for step
+
+  // 最良の途中解まで戻す
+  for (int step = d - 1; step > bestStep; step--)
+  {
+    int cadd = ws.pathIn[step - 1];
+    int cdel = ws.pathOut[step - 1];
+    cs.remove_column(inst, cadd);
+    remove_update_score(inst, cs, cadd, score);
+    cs.add_column(inst, cdel);
+    add_update_score(inst, cs, cdel, score);
+  }
+
+  return bestStep;
+}
+
+
+// GRASP初期解＋単純局所探索を niter 回繰り返し，w.best より良い解が見つかったら w.best に入れる
+// （w.best は呼び出し側で初期化するか，初期解を入れておく）
+// ctl が打ち切りを指示したらそこで終わる．最良解が更新されたら ctl に slot 番として知らせる
+// 戻り値は実際に行った反復の数
+template <typename Index, typename Counter>
+int grasp_neighborhood_search(SCPinstanceT<Index>& inst,
+                               GraspWorkspaceT<Index, Counter> &w,
+                               double alpha,
+                               int niter,
+                               mt19937_64& rnd,
+                               SearchControl& ctl,
+                               int slot)
+{
+  SCPsolutionT<Index, Counter>& cs = w.cs;
+  SCPsolutionT<Index, Counter>& best = w.best;
+  ScoreBucketT<Index>& score = w.score;
+
+  int iter;
+  for (iter = 1; iter <= niter; ++iter)
+  {
+    if (ctl.should_stop()) break;
+    long it = ctl.next_iteration();
+
+    // 初期解を生成（cs の領域を使い回す）
+    // スコアを初期化
+    score.initialize(inst);
+    if (w.construction == CONSTRUCT_GREEDY) greedy_construction(inst, cs, score, rnd);
+    else grasp_construction(inst, cs, score, alpha, rnd);
+
+    // 局所探索
+    ctl.add_moves(simple_neighborhood_search(inst, cs, score, w.swap, rnd));
+
+    // エリート解の一つへ path relinking し，良い途中解が見つかればそこから局所探索する．
+    // そのあと cs をエリート解のプールに入れてみる
+    if (w.pool.maxSize > 0)
+    {
+      int g = w.pool.random_member(rnd);
+      if (g >= 0 && path_relinking(inst, cs, score, w.pool.Cols[g], w.relink) > 0)
+      {
+        ctl.add_moves(simple_neighborhood_search(inst, cs, score, w.swap, rnd));
+      }
+      w.relink.cols.assign(cs.CS.begin(), cs.CS.end());
+      sort(w.relink.cols.begin(), w.relink.cols.end());
+      w.pool.add(w.relink.cols, cs.num_Cover);
+    }
+
+    // 改善したら best と領域ごと入れ替える（古い best は次の反復で初期化される）
+    if (best.num_Cover < cs.num_Cover)
+    {
+      best.swap(cs);
+      ctl.report(best.num_Cover, slot, it);
+    }
+  } // End for iter
+
+  return iter - 1;
+}
+
+
+
+//
+//  ビット集合版（--engine bitset）
+//  スコアを差分更新せず，列を選ぶたびに popcount で全ての列の gain を計算する
+//
+
+// score の中で，候補解に含まれない列の最大スコアの列をランダムに返す
+int get_column_maxscore(SCPbitsolution& bs,
+                        vector<int>& score,
+                        vector<int>& Cols,
+                        mt19937_64& rnd)
+{
+  int maxScore = 0;
+  Cols.clear();
+  for (int c = 0; c < bs.nCol; c++)
+  {
+    if (bs.SOLUTION[c]) { continue; }
+    if (maxScore < score[c])
+    {
+      maxScore = score[c];
+      Cols.clear();
+    }
+    if (maxScore == score[c]) Cols.push_back(c);
+  }
+
+  if (Cols.size() == 1) return Cols[0];
+  else return Cols[rnd() % Cols.size()];
+}
+
+
+// score の中で，候補解に含まれない列のうち
+// スコアが 最小値 + alpha * (最大値 - 最小値) 以上の列からランダムに一つ返す
+int get_column_grasp(SCPbitsolution& bs,
+                     vector<int>& score,
+                     vector<int>& Cols,
+                     double alpha,
+                     mt19937_64& rnd)
+{
+  int maxScore = -1, minScore = bs.nRow + 1;
+  for (int c = 0; c < bs.nCol; c++)
+  {
+    if (bs.SOLUTION[c]) { continue; }
+    if (maxScore < score[c]) maxScore = score[c];
+    if (minScore > score[c]) minScore = score[c];
+  }
+
+  // 閾値は maxScore を超えないようにする（少なくとも最大スコアの列は候補に残る）
+  double threshold = min(minScore + alpha * (maxScore - minScore), (double)maxScore);
+  Cols.clear();
+  for (int c = 0; c < bs.nCol; c++)
+  {
+    if (bs.SOLUTION[c]) { continue; }
+    if (score[c] >= threshold) Cols.push_back(c);
+  }
+
+  return Cols[rnd() % Cols.size()];
+}
+
+
+// GRASP法（ビット集合版）
+void grasp_construction(SCPbitinstance &binst,
+                        SCPbitsolution &bs,
+                        vector<int>& score,
+                        vector<int>& Cols,
+                        double alpha,
+                        mt19937_64& rnd)
+{
+  PROF_PHASE(PHASE_CONSTRUCTION);
+  bs.initialize(binst);
+  for (int k = 0; k < bs.K; k++)
+  {
+    bs.compute_scores(binst, score);
+    int c = get_column_grasp(bs, score, Cols, alpha, rnd);
+    bs.add_column(binst, c);
+  } // End for k
+}
+
+
+// 貪欲法（ビット集合版）：列を選ぶたびに全ての列の gain を計算して最大の列を選ぶ
+void greedy_construction(SCPbitinstance &binst,
+                         SCPbitsolution &bs,
+                         vector<int>& score,
+                         vector<int>& Cols,
+                         mt19937_64& rnd)
+{
+  PROF_PHASE(PHASE_CONSTRUCTION);
+  bs.initialize(binst);
+  for (int k = 0; k < bs.K; k++)
+  {
+    bs.compute_scores(binst, score);
+    int c = get_column_maxscore(bs, score, Cols, rnd);
+    bs.add_column(binst, c);
+  } // End for k
+}
+
+
+// 遅延評価の貪欲法（CELF，ビット集合版）：greedy_construction と同じ規則で選ぶ
+// 列の gain は列を加えるほど減らない（劣モジュラ）ので，gain の上界が最大の列だけ
+// popcount で gain を計算し直し，上界のままならその列を選ぶ．そうでなければ
+// 計算した gain を新しい上界にする．上界は整数なので，ヒープの代わりに上界ごとの
+// スタック（w.top, w.next）で持つ．最初の上界は列の大きさで，同点の列はランダムな順に積む．
+void lazy_greedy_construction(SCPbitinstance &binst,
+                              BitGraspWorkspace &w,
+                              mt19937_64& rnd)
+{
+  PROF_PHASE(PHASE_CONSTRUCTION);
+  SCPbitsolution& bs = w.bs;
+  bs.initialize(binst);
+
+  for (int b = 0; b <= binst.numRows; b++) w.top[b] = -1;
+  w.Cols.resize(binst.numColumns);
+  for (int j = 0; j < binst.numColumns; j++) w.Cols[j] = j;
+  random_permutation(w.Cols, rnd);
+  for (int j : w.Cols)
+  {
+    w.next[j] = w.top[w.size[j]];
+    w.top[w.size[j]] = j;
+  }
+
+  int maxb = binst.numRows;
+  for (int k = 0; k < bs.K; k++)
+  {
+    for (;;)
+    {
+      while (maxb >= 0 && w.top[maxb] < 0) maxb--;
+      if (maxb < 0) break;              // 列が残っていない
+      int c = w.top[maxb];
+      w.top[maxb] = w.next[c];
+
+      PROF_CALL(PROF_LAZY_GAIN, binst.nWords);
+      int g = bs.gain(binst, c);
+      if (g == maxb)                    // 他の列の上界以上
+      {
+        bs.add_column(binst, c);
+        break;
+      }
+      w.next[c] = w.top[g];
+      w.top[g] = c;
+    }
+  } // End for k
+}
+
+
+// 単純な改善法（ビット集合版）．戻り値は評価した (c1, c2) の交換の数
+// （c1 を抜くたびに解に入っていない全ての列のスコアを求める）
+long simple_neighborhood_search(SCPbitinstance &binst,
+                                SCPbitsolution &bs,
+                                vector<int>& score,
+                                vector<int>& Cols,
+                                vector<int>& idx,
+                                mt19937_64& rnd)
+{
+  PROF_PHASE(PHASE_LOCAL_SEARCH);
+  int K = bs.K;
+  int c1, cov1;
+  int c2, cov2;
+  long nEval = 0;
+
+  idx.assign(bs.CS.begin(), bs.CS.end());
+  random_permutation(idx, rnd);
+  cov1 = bs.num_Cover;
+
+  for (int i = 0; i < K; ++i)
+  {
+    c1 = idx[i];
+    bs.remove_column(binst, c1);
+
+    // 最大スコアの列
+    bs.compute_scores(binst, score);
+    nEval += binst.numColumns - (K - 1);
+    c2 = get_column_maxscore(bs, score, Cols, rnd);
+    bs.add_column(binst, c2);
+    cov2 = bs.num_Cover;
+    if (cov1 > cov2)
+    {
+      bs.remove_column(binst, c2);
+      bs.add_column(binst, c1);
+    }
+    else
+    {
+      cov1 = bs.num_Cover;
+    }
+  } // End for i
+
+  return nEval;
+}
+
+
+// GRASP初期解＋単純局所探索を niter 回繰り返し（ビット集合版）
+// w.best より良い解が見つかったら w.best に入れ，最後に w.best を best に移す
+// 戻り値は実際に行った反復の数
+int grasp_neighborhood_search(SCPinstance &inst,
+                               SCPbitinstance &binst,
+                               BitGraspWorkspace &w,
+                               SCPsolution &best,
+                               double alpha,
+                               int niter,
+                               mt19937_64& rnd,
+                               SearchControl& ctl,
+                               int slot)
+{
+  SCPbitsolution& bs = w.bs;
+  SCPbitsolution& best_bs = w.best;
+
+  int iter;
+  for (iter = 1; iter <= niter; ++iter)
+  {
+    if (ctl.should_stop()) break;
+    long it = ctl.next_iteration();
+
+    if (w.construction == CONSTRUCT_LAZY) lazy_greedy_construction(binst, w, rnd);
+    else if (w.construction == CONSTRUCT_GREEDY) greedy_construction(binst, bs, w.score, w.Cols, rnd);
+    else grasp_construction(binst, bs, w.score, w.Cols, alpha, rnd);
+    ctl.add_moves(simple_neighborhood_search(binst, bs, w.score, w.Cols, w.order, rnd));
+
+    if (best_bs.num_Cover < bs.num_Cover)
+    {
+      best_bs.swap(bs);
+      ctl.report(best_bs.num_Cover, slot, it);
+    }
+  } // End for iter
+
+  best.initialize(inst);
+  for (int c : best_bs.CS)
+  {
+    if (c < inst.numColumns) best.add_column(inst, c);
+  }
+
+  return iter - 1;
+}
+
+
+
+// スレッド t 用の乱数生成器の種を seed から作る
+// スレッドごとに独立な系列になり，seed とスレッド数が同じなら結果も同じになる
+mt19937_64 thread_random_engine(uint64_t seed, int t)
+{
+  std::seed_seq seq{(uint32_t)seed, (uint32_t)(seed >> 32), (uint32_t)t};
+  return mt19937_64(seq);
+}
+
+
+// 初期解 warm に局所探索を改善しなくなるまで繰り返し，w.best に入れる（リスト版）
+// warm は元のインスタンスの列番号．縮小で除かれた列の代わりはスコア最大の列で補う
+template <typename Index, typename Counter>
+static void start_from_solution(SCPinstanceT<Index> &inst,
+                                GraspWorkspaceT<Index, Counter> &w,
+                                const SCPsolution &warm,
+                                mt19937_64& rnd,
+                                SearchControl& ctl)
+{
+  w.score.initialize(inst);
+  w.cs.initialize(inst);
+  int n = 0;
+  for (int c : warm.CS)
+  {
+    if (c >= (int)inst.ReducedColumn.size()) continue;
+    c = inst.ReducedColumn[c];
+    if (c < 0 || w.cs.is_selected(c)) continue;
+    w.cs.add_column(inst, c);
+    add_update_score(inst, w.cs, c, w.score);
+    n++;
+  }
+  for (; n < w.cs.K; n++)
+  {
+    int c = get_column_maxscore(inst, w.cs, w.score, rnd);
+    w.cs.add_column(inst, c);
+    add_update_score(inst, w.cs, c, w.score);
+  }
+
+  int cov;
+  do
+  {
+    cov = w.cs.num_Cover;
+    ctl.add_moves(simple_neighborhood_search(inst, w.cs, w.score, w.swap, rnd));
+  } while (w.cs.num_Cover > cov);
+
+  w.best.swap(w.cs);
+}
+
+
+// 初期解 warm に局所探索を改善しなくなるまで繰り返し，w.best に入れる（ビット集合版）
+static void start_from_solution(SCPbitinstance &binst,
+                                BitGraspWorkspace &w,
+                                const SCPsolution &warm,
+                                mt19937_64& rnd,
+                                SearchControl& ctl)
+{
+  w.bs.initialize(binst);
+  for (int c : warm.CS)
+  {
+    if (c < binst.numColumns) w.bs.add_column(binst, c);
+  }
+
+  int cov;
+  do
+  {
+    cov = w.bs.num_Cover;
+    ctl.add_moves(simple_neighborhood_search(binst, w.bs, w.score, w.Cols, w.order, rnd));
+  } while (w.bs.num_Cover > cov);
+
+  w.best.swap(w.bs);
+}
+
+
+// チェックポイントから再開する：乱数の状態と，終わった再スタートの解（Result）を戻す
+// 戻り値は途中だった再スタートの番号（保存した状態がなければ 0）
+static int resume_thread(SCPinstance &inst,
+                         const ThreadCheckpoint &s,
+                         int nthreads,
+                         int t,
+                         mt19937_64& rnd,
+                         vector<SCPsolution>& Result,
+                         SearchControl& ctl)
+{
+  if (s.rng.empty()) return 0;
+  istringstream in(s.rng);
+  in >> rnd;
+  for (int i = 0; i < s.restart; i++)
+  {
+    int slot = i * nthreads + t;
+    Result[slot].initialize(inst);
+    for (int c : s.done[i]) Result[slot].add_column(inst, c);
+    ctl.report(Result[slot].num_Cover, slot, ctl.Iterations.load());
+  }
+  ctl.Iterations += s.iterations;
+  return s.restart;
+}
+
+
+// 再スタート restart の iter 回目の反復まで終わった状態（乱数と反復の数）を s に入れる
+static void snapshot_thread(ThreadCheckpoint &s, int restart, int iter, mt19937_64& rnd)
+{
+  ostringstream out;
+  out << rnd;
+  s.restart = restart;
+  s.iter = iter;
+  s.rng = out.str();
+}
+
+
+// 再スタート i が終わった：解 res を s.done に足し，次の再スタートの最初の状態にする
+static void finish_restart(ThreadCheckpoint &s, int i, const SCPsolution &res, mt19937_64& rnd)
+{
+  s.done.resize(i + 1);
+  s.done[i].clear();
+  for (int c : res.CS)
+  {
+    if (c < res.nCol) s.done[i].push_back(c);
+  }
+  s.best.clear();
+  s.poolCols.clear();
+  s.poolCover.clear();
+  snapshot_thread(s, i + 1, 0, rnd);
+}
+
+
+// 今の再スタートの最良解とエリート解を s に入れる（リスト版）
+template <typename Index, typename Counter>
+static void snapshot_workspace(ThreadCheckpoint &s, GraspWorkspaceT<Index, Counter> &w)
+{
+  s.best.clear();
+  for (int c : w.best.CS)
+  {
+    if (c < w.best.nCol) s.best.push_back(c);
+  }
+  s.poolCols.resize(w.pool.size);
+  s.poolCover.resize(w.pool.size);
+  for (int p = 0; p < w.pool.size; p++)
+  {
+    s.poolCols[p].assign(w.pool.Cols[p].begin(), w.pool.Cols[p].end());
+    s.poolCover[p] = w.pool.Cover[p];
+  }
+}
+
+
+// ws の中のスレッド t の作業領域（Index, Counter の組で選ぶ）
+static std::unique_ptr<GraspWorkspaceT<uint16_t, uint8_t>>&
+workspace_slot(SearchWorkspaces& ws, int t, GraspWorkspaceT<uint16_t, uint8_t>*) { return ws.Compact[t]; }
+static std::unique_ptr<GraspWorkspaceT<int, int>>&
+workspace_slot(SearchWorkspaces& ws, int t, GraspWorkspaceT<int, int>*) { return ws.Wide[t]; }
+
+
+// スレッド t の担当分（リスト版）：再スタートを nrestart 回
+// 作業領域はスレッドごとに1回だけ確保する
+// warm が NULL でなければ，スレッド 0 の最初の再スタートはその解から始める（エリート解のプールにも入れる）
+// nelite はエリート解のプールの大きさ（0 なら path relinking をしない），construction は初期解を作る方法（grasp か greedy）
+// ckpt が NULL でなければ1反復ずつ進め，保存する時刻になったら状態を ckpt に渡す
+// ws が NULL でなければ作業領域を ws から使い回す（なければ作って ws に残す）
+template <typename Index, typename Counter>
+static void list_search_thread(SCPinstance &inst,
+                               SCPinstanceT<Index> &cinst,
+                               int K,
+                               double alpha,
+                               int share,
+                               int nrestart,
+                               int nthreads,
+                               int t,
+                               mt19937_64& rnd,
+                               vector<SCPsolution>& Result,
+                               SearchControl& ctl,
+                               const SCPsolution* warm,
+                               int nelite,
+                               SCPconstruction construction,
+                               SCPcheckpoint* ckpt,
+                               SearchWorkspaces* ws)
+{
+  std::unique_ptr<GraspWorkspaceT<Index, Counter>> local;
+  std::unique_ptr<GraspWorkspaceT<Index, Counter>>& slot0 =
+    (ws != NULL) ? workspace_slot(*ws, t, (GraspWorkspaceT<Index, Counter>*)NULL) : local;
+  if (!slot0) slot0.reset(new GraspWorkspaceT<Index, Counter>(cinst, K, nelite, construction));
+  GraspWorkspaceT<Index, Counter>& w = *slot0;
+  ThreadCheckpoint snap;
+  int first = 0;
+  if (ckpt != NULL)
+  {
+    snap = ckpt->Threads[t];
+    first = resume_thread(inst, snap, nthreads, t, rnd, Result, ctl);
+  }
+
+  for (int i = first; i < nrestart; i++)
+  {
+    int slot = i * nthreads + t;
+    int done = 0;               // この再スタートで終えた反復の数
+    w.best.initialize(cinst);
+    w.pool.clear();             // 再スタートどうしは独立に探索する
+    if (i == first && snap.iter > 0)
+    {
+      // 再スタートの途中から再開する
+      for (int c : snap.best) w.best.add_column(cinst, c);
+      for (size_t p = 0; p < snap.poolCols.size(); p++)
+      {
+        w.pool.Cols[p].assign(snap.poolCols[p].begin(), snap.poolCols[p].end());
+        w.pool.Cover[p] = snap.poolCover[p];
+      }
+      w.pool.size = snap.poolCols.size();
+      done = snap.iter;
+      ctl.report(w.best.num_Cover, slot, ctl.Iterations.load());
+    }
+    else if (warm != NULL && t == 0 && i == 0)
+    {
+      start_from_solution(cinst, w, *warm, rnd, ctl);
+      ctl.report(w.best.num_Cover, slot, ctl.Iterations.load());
+
+      // エリート解のプールにも入れ，path relinking の相手にする
+      if (w.pool.maxSize > 0)
+      {
+        w.relink.cols.assign(w.best.CS.begin(), w.best.CS.end());
+        sort(w.relink.cols.begin(), w.relink.cols.end());
+        w.pool.add(w.relink.cols, w.best.num_Cover);
+      }
+    }
+
+    if (ckpt == NULL) grasp_neighborhood_search(cinst, w, alpha, share, rnd, ctl, slot);
+    while (ckpt != NULL && done < share)
+    {
+      // 打ち切られて反復しなかったときは数えない
+      int n = grasp_neighborhood_search(cinst, w, alpha, 1, rnd, ctl, slot);
+      if (n == 0) break;
+      snap.iterations += n;
+      done += n;
+      if (ckpt->due(t))
+      {
+        snapshot_workspace(snap, w);
+        snapshot_thread(snap, i, done, rnd);
+        ckpt->update(t, snap, ctl);
+      }
+    }
+    w.best.to_solution(cinst, inst, Result[slot]);
+    ctl.report(Result[slot].num_Cover, slot, ctl.Iterations.load());
+
+    if (ckpt != NULL)
+    {
+      if (done < share)
+      {
+        snapshot_workspace(snap, w);
+        snapshot_thread(snap, i, done, rnd);
+      }
+      else finish_restart(snap, i, Result[slot], rnd);
+      ckpt->update(t, snap, ctl);
+    }
+  }
+}
+
+
+// 今の再スタートの最良解を s に入れる（ビット集合版）
+static void snapshot_bitset(ThreadCheckpoint &s, BitGraspWorkspace &w)
+{
+  s.best.clear();
+  for (int c : w.best.CS)
+  {
+    if (c < w.best.nCol) s.best.push_back(c);
+  }
+}
+
+
+// スレッド t の担当分（ビット集合版）
+static void bitset_search_thread(SCPinstance &inst,
+                                 SCPbitinstance &binst,
+                                 int K,
+                                 double alpha,
+                                 int share,
+                                 int nrestart,
+                                 int nthreads,
+                                 int t,
+                                 mt19937_64& rnd,
+                                 vector<SCPsolution>& Result,
+                                 SearchControl& ctl,
+                                 const SCPsolution* warm,
+                                 SCPconstruction construction,
+                                 SCPcheckpoint* ckpt,
+                                 SearchWorkspaces* ws)
+{
+  std::unique_ptr<BitGraspWorkspace> local;
+  std::unique_ptr<BitGraspWorkspace>& slot0 = (ws != NULL) ? ws->Bits[t] : local;
+  if (!slot0) slot0.reset(new BitGraspWorkspace(binst, K, construction));
+  BitGraspWorkspace& w = *slot0;
+  ThreadCheckpoint snap;
+  int first = 0;
+  if (ckpt != NULL)
+  {
+    snap = ckpt->Threads[t];
+    first = resume_thread(inst, snap, nthreads, t, rnd, Result, ctl);
+  }
+
+  for (int i = first; i < nrestart; i++)
+  {
+    int slot = i * nthreads + t;
+    int done = 0;
+    w.best.initialize(binst);
+    if (i == first && snap.iter > 0)
+    {
+      for (int c : snap.best) w.best.add_column(binst, c);
+      done = snap.iter;
+      ctl.report(w.best.num_Cover, slot, ctl.Iterations.load());
+    }
+    else if (warm != NULL && t == 0 && i == 0)
+    {
+      start_from_solution(binst, w, *warm, rnd, ctl);
+      ctl.report(w.best.num_Cover, slot, ctl.Iterations.load());
+    }
+
+    if (ckpt == NULL) grasp_neighborhood_search(inst, binst, w, Result[slot], alpha, share, rnd, ctl, slot);
+    while (ckpt != NULL && done < share)
+    {
+      // 打ち切られて反復しなかったときは数えない
+      int n = grasp_neighborhood_search(inst, binst, w, Result[slot], alpha, 1, rnd, ctl, slot);
+      if (n == 0) break;
+      snap.iterations += n;
+      done += n;
+      if (ckpt->due(t))
+      {
+        snapshot_bitset(snap, w);
+        snapshot_thread(snap, i, done, rnd);
+        ckpt->update(t, snap, ctl);
+      }
+    }
+    if (ckpt != NULL)           // 1回も反復しなかったときも w.best を Result[slot] に移す
+      grasp_neighborhood_search(inst, binst, w, Result[slot], alpha, 0, rnd, ctl, slot);
+    ctl.report(Result[slot].num_Cover, slot, ctl.Iterations.load());
+
+    if (ckpt != NULL)
+    {
+      if (done < share)
+      {
+        snapshot_bitset(snap, w);
+        snapshot_thread(snap, i, done, rnd);
+      }
+      else finish_restart(snap, i, Result[slot], rnd);
+      ckpt->update(t, snap, ctl);
+    }
+  }
+}
+
+
+// grasp_neighborhood_search を nrestart 回，nthreads 個のスレッドで実行する
+// 各再スタートの niter 回の反復をスレッドで分けあう．
+// スレッド t が再スタート i で見つけた最良解は Result[i * nthreads + t] に入る．
+// binst が NULL でなければビット集合版を使う．
+// そうでなければ linst のリスト版を使う（linst は全スレッドで共有する）．
+// warm が NULL でなければ，スレッド 0 の最初の再スタートはその解（列数 K）から始める．
+// nelite > 0 ならリスト版はエリート解のプールと path relinking を使う（ビット集合版は無視する）．
+// construction は初期解を作る方法（lazy はビット集合版のみ）．
+// 全体の最良解と打ち切りは ctl で管理する．戻り値は全体の最良解の番号．
+int parallel_grasp_neighborhood_search(SCPinstance &inst,
+                                       SCPbitinstance *binst,
+                                       ListInstance *linst,
+                                       int K,
+                                       double alpha,
+                                       int niter,
+                                       int nrestart,
+                                       int nthreads,
+                                       uint64_t seed,
+                                       vector<SCPsolution>& Result,
+                                       SearchControl& ctl,
+                                       const SCPsolution* warm,
+                                       int nelite,
+                                       SCPconstruction construction,
+                                       SCPcheckpoint* ckpt,
+                                       SearchWorkspaces* ws)
+{
+  vector<thread> pool;
+  if (ws != NULL) ws->prepare(K, nelite, construction, nthreads);
+
+  for (int t = 0; t < nthreads; t++)
+  {
+    pool.push_back(thread([&, t]()
+    {
+      mt19937_64 rnd = thread_random_engine(seed, t);
+      int share = niter / nthreads + (t < niter % nthreads ? 1 : 0);
+
+      if (binst != NULL)
+        bitset_search_thread(inst, *binst, K, alpha, share, nrestart, nthreads, t, rnd, Result, ctl, warm, construction, ckpt, ws);
+      else if (linst->compact != NULL)
+        list_search_thread<uint16_t, uint8_t>(inst, *linst->compact, K, alpha, share, nrestart, nthreads, t, rnd, Result, ctl, warm, nelite, construction, ckpt, ws);
+      else
+        list_search_thread<int, int>(inst, *linst->wide, K, alpha, share, nrestart, nthreads, t, rnd, Result, ctl, warm, nelite, construction, ckpt, ws);
+    }));
+  }
+  for (thread& th : pool) th.join();
+
+  return ctl.best_slot();
+}
+
+
+// 使う幅の組み合わせ（rnkc.hpp で宣言した関数）
+#define INSTANTIATE_LIST_ENGINE(I, C)                                   \
+  template void add_update_score(SCPinstanceT<I>&, SCPsolutionT<I, C>&, int, ScoreBucketT<I>&); \
+  template void remove_update_score(SCPinstanceT<I>&, SCPsolutionT<I, C>&, int, ScoreBucketT<I>&); \
+  template int get_column_maxscore(SCPinstanceT<I>&, SCPsolutionT<I, C>&, ScoreBucketT<I>&, mt19937_64&); \
+  template int get_column_grasp(SCPinstanceT<I>&, SCPsolutionT<I, C>&, ScoreBucketT<I>&, double, mt19937_64&); \
+  template void greedy_construction(SCPinstanceT<I>&, SCPsolutionT<I, C>&, ScoreBucketT<I>&, mt19937_64&); \
+  template void grasp_construction(SCPinstanceT<I>&, SCPsolutionT<I, C>&, ScoreBucketT<I>&, double, mt19937_64&); \
+  template int swap_delta(SCPinstanceT<I>&, SCPsolutionT<I, C>&, ScoreBucketT<I>&, int, int); \
+  template int best_swap_column(SCPinstanceT<I>&, SCPsolutionT<I, C>&, ScoreBucketT<I>&, int, SwapWorkspaceT<I>&, mt19937_64&, int&, long&); \
+  template long simple_neighborhood_search(SCPinstanceT<I>&, SCPsolutionT<I, C>&, ScoreBucketT<I>&, SwapWorkspaceT<I>&, mt19937_64&); \
+  template int path_relinking(SCPinstanceT<I>&, SCPsolutionT<I, C>&, ScoreBucketT<I>&, const vector<I>&, RelinkWorkspaceT<I>&); \
+  template int grasp_neighborhood_search(SCPinstanceT<I>&, GraspWorkspaceT<I, C>&, double, int, mt19937_64&, SearchControl&, int);
+
+INSTANTIATE_LIST_ENGINE(uint16_t, uint8_t)
+INSTANTIATE_LIST_ENGINE(int, int)
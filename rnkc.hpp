@@ -0,0 +1,365 @@
+//---------------------------------------------------------------------------
+// 最大 K 被覆問題の解法（貪欲法・GRASP・局所探索）
+// rnkc_main.cpp と rnkc_bench.cpp から使う
+// Araki
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "SCPv.hpp"
+#include "SCPcompact.hpp"
+#include "ScoreBucket.hpp"
+#include "ElitePool.hpp"
+#include "SCPbitset.hpp"
+#include "SearchControl.hpp"
+#include "Checkpoint.hpp"
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <memory>
+
+// 交換近傍の評価に使う作業領域
+template <typename Index>
+struct SwapWorkspaceT
+{
+  typedef typename ScoreBucketT<Index>::Score Score;
+
+  std::vector<Score> bonus;     // bonus[j]: 列outを削除すると列jのスコアが増える量
+  std::vector<Index> touched;   // bonus が 0 でない列
+  std::vector<Index> order;     // 局所探索で削除候補の列を調べる順序
+
+  SwapWorkspaceT(SCPinstanceT<Index> &inst) : bonus(inst.numColumns, 0)
+  {
+    touched.reserve(inst.numColumns);
+  }
+};
+
+// path relinking で使う作業領域
+template <typename Index>
+struct RelinkWorkspaceT
+{
+  std::vector<Index> cols;      // 解の列（昇順）
+  std::vector<Index> in;        // 目標の解にだけある列（これから加える列）
+  std::vector<Index> out;       // 作業中の解にだけある列（これから除く列）
+  std::vector<Index> pathIn;    // ステップごとに加えた列
+  std::vector<Index> pathOut;   // ステップごとに除いた列
+
+  RelinkWorkspaceT(int K)
+  {
+    cols.reserve(K);
+    in.reserve(K);
+    out.reserve(K);
+    pathIn.reserve(K);
+    pathOut.reserve(K);
+  }
+};
+
+// GRASP の反復で初期解を作る方法
+// リスト版はスコアをバケットで差分更新しているので，スコア最大の列は O(1) で取り出せる．
+// lazy（gain を必要なときだけ計算し直す貪欲法）は，全ての列の gain を popcount で
+// 計算し直すビット集合版だけで使う．
+enum SCPconstruction
+{
+  CONSTRUCT_GRASP,              // grasp_construction（既定）
+  CONSTRUCT_GREEDY,             // greedy_construction
+  CONSTRUCT_LAZY                // lazy_greedy_construction（ビット集合版のみ）
+};
+
+// GRASP の反復で使う作業領域
+// スレッドごとに1回だけ確保し，反復のたびに中身を初期化して使い回す．
+// 反復の途中ではヒープを確保しない．
+// nelite > 0 なら局所最適解を nelite 個までエリート解のプールに入れ，path relinking に使う．
+// プールに入れる解どうしは K/10 列（最低1列）以上違うものにする．
+template <typename Index, typename Counter>
+struct GraspWorkspaceT
+{
+  SCPsolutionT<Index, Counter> cs;   // 作業中の解
+  SCPsolutionT<Index, Counter> best; // 最良解
+  ScoreBucketT<Index> score;         // cs に対するスコア
+  SwapWorkspaceT<Index> swap;        // 交換近傍の作業領域
+  ElitePoolT<Index> pool;            // エリート解
+  RelinkWorkspaceT<Index> relink;    // path relinking の作業領域
+  SCPconstruction construction;      // 初期解を作る方法（grasp か greedy）
+
+  GraspWorkspaceT(SCPinstanceT<Index> &inst, int K, int nelite = 0,
+                  SCPconstruction construction = CONSTRUCT_GRASP)
+    : cs(inst, K), best(inst, K), score(inst), swap(inst),
+      pool(nelite, K, 2 * std::max(1, K / 10)), relink(K), construction(construction)
+  {
+    swap.order.reserve(K);
+  }
+};
+
+// リスト版の探索で使うインスタンス
+// 読み込んだ後に1回だけ作り，全スレッド（--k-range では全ての K）で共有する．
+// width に合わせて compact か wide の一方だけを作る．
+struct ListInstance
+{
+  SCPwidth width;
+  SCPinstanceT<uint16_t>* compact;
+  SCPinstanceT<int>* wide;
+
+  // reduce なら重複する行をまとめ，支配される列を除く（K 列は残す）
+  // reorder なら行と列の番号をキャッシュに合わせて付け替える
+  ListInstance(SCPinstance &inst, SCPwidth w, bool reduce, int K, bool reorder = false)
+    : width(w), compact(NULL), wide(NULL)
+  {
+    if (width == WIDTH_COMPACT) compact = new SCPinstanceT<uint16_t>(inst, reduce, K, reorder);
+    else wide = new SCPinstanceT<int>(inst, reduce, K, reorder);
+  }
+  ~ListInstance()
+  {
+    delete compact;
+    delete wide;
+  }
+  ListInstance(const ListInstance&) = delete;
+  ListInstance& operator=(const ListInstance&) = delete;
+
+  int numRows() const { return compact ? compact->numRows : wide->numRows; }
+  int numColumns() const { return compact ? compact->numColumns : wide->numColumns; }
+};
+
+// GRASP の反復で使う作業領域（ビット集合版）
+struct BitGraspWorkspace
+{
+  SCPbitsolution bs;            // 作業中の解
+  SCPbitsolution best;          // 最良解
+  std::vector<int> score;       // bs に対するスコア
+  std::vector<int> Cols;        // GRASP の候補列
+  std::vector<int> order;       // 局所探索で削除候補の列を調べる順序
+  SCPconstruction construction; // 初期解を作る方法
+
+  // lazy_greedy_construction で使う（lazy のときだけ確保）
+  std::vector<int> size;        // size[j]: 列jがカバーする行の数（gain の最初の上界）
+  std::vector<int> top;         // top[b]: gain の上界が b の列のスタックの先頭（空なら -1）
+  std::vector<int> next;        // next[j]: スタックで列jの次の列
+
+  BitGraspWorkspace(SCPbitinstance &binst, int K,
+                    SCPconstruction construction = CONSTRUCT_GRASP)
+    : bs(binst, K), best(binst, K), score(binst.numColumns, 0), construction(construction)
+  {
+    Cols.reserve(binst.numColumns);
+    order.reserve(K);
+    if (construction == CONSTRUCT_LAZY)
+    {
+      size.resize(binst.numColumns);
+      bs.initialize(binst);
+      bs.compute_scores(binst, size);
+      top.resize(binst.numRows + 1);
+      next.resize(binst.numColumns);
+    }
+  }
+};
+
+// スレッドごとの探索の作業領域
+// parallel_grasp_neighborhood_search を同じインスタンスで何度も呼ぶときに渡すと，
+// K・nelite・construction が前の呼び出しと同じなら作業領域を確保し直さずに使い回す．
+// 同時に2つの探索に渡してはいけない
+struct SearchWorkspaces
+{
+  int K;
+  int nelite;
+  SCPconstruction construction;
+  std::vector<std::unique_ptr<GraspWorkspaceT<uint16_t, uint8_t>>> Compact;
+  std::vector<std::unique_ptr<GraspWorkspaceT<int, int>>> Wide;
+  std::vector<std::unique_ptr<BitGraspWorkspace>> Bits;
+
+  SearchWorkspaces() : K(0), nelite(0), construction(CONSTRUCT_GRASP) {}
+
+  // K などが前と違えば作業領域を捨て，nthreads 個のスレッドの場所を用意する
+  void prepare(int k, int nel, SCPconstruction con, int nthreads)
+  {
+    if (k != K || nel != nelite || con != construction)
+    {
+      Compact.clear();
+      Wide.clear();
+      Bits.clear();
+      K = k;
+      nelite = nel;
+      construction = con;
+    }
+    if ((int)Compact.size() < nthreads)
+    {
+      Compact.resize(nthreads);
+      Wide.resize(nthreads);
+      Bits.resize(nthreads);
+    }
+  }
+};
+
+
+// 解csがカバーする要素数を返す
+int check_number_of_covered_elements(SCPinstance& inst,
+                                     SCPsolution& cs);
+
+// 解 from の列を足し引きして，列数 to.K の解 to を作る（K を変えて解き直すときの初期解）
+// 列が足りなければ新たにカバーする行が最大の列を，多ければカバーされなくなる行が
+// 最小の列を1列ずつ選ぶ（同点なら番号の小さい列）
+void resize_solution(SCPinstance& inst,
+                     SCPsolution& from,
+                     SCPsolution& to);
+
+// ファイルから解を読み，resize_solution で列数 to.K の解 to にする
+// ファイルは print_solution と同じく1から数えた列番号を空白で区切って並べたもの．
+// インスタンスにない列番号・重複した列番号は飛ばす．戻り値は飛ばした列番号の数
+// （ファイルが開けない・数でないものがあれば DataException）
+int read_solution(SCPinstance& inst,
+                  const char* FileName,
+                  SCPsolution& to);
+
+// 解 cs の列番号を（1から数えて）ファイルに書く．書けなければ false
+bool write_solution(const char* FileName,
+                    SCPsolution& cs);
+
+//
+//  以下の Index, Counter は添字と被覆回数の型（SCPcompact.hpp）．
+//  rnkc.cpp で (uint16_t, uint8_t) と (int, int) を実体化する．
+//
+
+// 列cを解に追加したときのscoreの更新
+template <typename Index, typename Counter>
+void add_update_score(SCPinstanceT<Index>& inst,
+                      SCPsolutionT<Index, Counter>& cs,
+                      int c,
+                      ScoreBucketT<Index>& score);
+
+// 列cを解から削除したときのscoreの更新
+template <typename Index, typename Counter>
+void remove_update_score(SCPinstanceT<Index>& inst,
+                         SCPsolutionT<Index, Counter>& cs,
+                         int c,
+                         ScoreBucketT<Index>& score);
+
+// 候補解csに含まれてない中で，スコア最大の列を返す
+template <typename Index, typename Counter>
+int get_column_maxscore(SCPinstanceT<Index>& inst,
+                        SCPsolutionT<Index, Counter>& CS,
+                        ScoreBucketT<Index>& score,
+                        std::mt19937_64& rnd);
+
+// 候補解csに含まれてない中で，スコアが alpha で決まる閾値以上の列をランダムに返す
+// （0 <= alpha <= 1）
+template <typename Index, typename Counter>
+int get_column_grasp(SCPinstanceT<Index>& inst,
+                     SCPsolutionT<Index, Counter>& CS,
+                     ScoreBucketT<Index>& score,
+                     double alpha,
+                     std::mt19937_64& rnd);
+
+// 貪欲法：スコア最大の列をK列選ぶ
+template <typename Index, typename Counter>
+void greedy_construction(SCPinstanceT<Index>& inst,
+                         SCPsolutionT<Index, Counter>& cs,
+                         ScoreBucketT<Index>& score,
+                         std::mt19937_64& rnd);
+
+// GRASP法：スコアが alpha * (最大値 - 最小値) 以上である列からランダムに一つ選ぶ
+// cs を初期化してから cs.K 列を選ぶ（score は初期化済みであること）
+template <typename Index, typename Counter>
+void grasp_construction(SCPinstanceT<Index> &inst,
+                        SCPsolutionT<Index, Counter> &cs,
+                        ScoreBucketT<Index>& score,
+                        double alpha,
+                        std::mt19937_64& rnd);
+
+// 配列の順序をランダムに入れ替える
+template <typename T>
+void random_permutation(std::vector<T>& A,
+                        std::mt19937_64& rnd)
+{
+  int n = A.size();
+  int j;
+  for (int i = 0; i < n-1; ++i)
+  {
+    j = rnd() % (n-i);
+    std::swap(A[i], A[i+j]);
+  }
+}
+
+// 列outを削除して列inを追加したときの num_Cover の変化量（状態は変えない）
+template <typename Index, typename Counter>
+int swap_delta(SCPinstanceT<Index>& inst,
+               SCPsolutionT<Index, Counter>& cs,
+               ScoreBucketT<Index>& score,
+               int out,
+               int in);
+
+// 列outを削除したときに，代わりに追加するとカバー数が最大になる列を返す（状態は変えない）
+template <typename Index, typename Counter>
+int best_swap_column(SCPinstanceT<Index>& inst,
+                     SCPsolutionT<Index, Counter>& cs,
+                     ScoreBucketT<Index>& score,
+                     int out,
+                     SwapWorkspaceT<Index>& ws,
+                     std::mt19937_64& rnd,
+                     int& delta,
+                     long& nEval);
+
+// 単純な改善法（戻り値は評価した交換の数）
+template <typename Index, typename Counter>
+long simple_neighborhood_search(SCPinstanceT<Index> &inst,
+                                SCPsolutionT<Index, Counter> &cs,
+                                ScoreBucketT<Index>& score,
+                                SwapWorkspaceT<Index>& ws,
+                                std::mt19937_64& rnd);
+
+// 解 cs から解 guide（昇順の列リスト）へ1列ずつ交換しながら近づき（path relinking），
+// 途中の解のうちカバー数が cs より大きい最良の解を cs に残す．
+// 戻り値はその解までに交換した列の数（0 なら cs は元のまま）
+template <typename Index, typename Counter>
+int path_relinking(SCPinstanceT<Index>& inst,
+                   SCPsolutionT<Index, Counter>& cs,
+                   ScoreBucketT<Index>& score,
+                   const std::vector<Index>& guide,
+                   RelinkWorkspaceT<Index>& ws);
+
+// GRASP初期解＋単純局所探索を niter 回繰り返し，最良解を w.best に入れる
+// w.pool の大きさが 0 でなければ，局所最適解とプールの解の間で path relinking をする
+// 解の大きさ K は w を作ったときの K．戻り値は実際に行った反復の数
+template <typename Index, typename Counter>
+int grasp_neighborhood_search(SCPinstanceT<Index> &inst,
+                               GraspWorkspaceT<Index, Counter> &w,
+                               double alpha,
+                               int niter,
+                               std::mt19937_64& rnd,
+                               SearchControl& ctl,
+                               int slot);
+
+// GRASP初期解＋単純局所探索を niter 回繰り返し（ビット集合版）．戻り値は実際に行った反復の数
+int grasp_neighborhood_search(SCPinstance &inst,
+                               SCPbitinstance &binst,
+                               BitGraspWorkspace &w,
+                               SCPsolution &best,
+                               double alpha,
+                               int niter,
+                               std::mt19937_64& rnd,
+                               SearchControl& ctl,
+                               int slot);
+
+// スレッド t 用の乱数生成器の種を seed から作る
+std::mt19937_64 thread_random_engine(uint64_t seed, int t);
+
+// grasp_neighborhood_search を nrestart 回，nthreads 個のスレッドで実行する
+// binst が NULL でなければビット集合版を，そうでなければ linst のリスト版を使う
+// warm が NULL でなければ，スレッド 0 の最初の再スタートはその解から局所探索を始める
+// nelite > 0 ならリスト版でエリート解のプール（スレッドごと，再スタートごと）と path relinking を使う
+// construction は初期解を作る方法（lazy はビット集合版のみ）
+// ckpt が NULL でなければ，ckpt の状態から再開し，探索の途中の状態を ckpt に保存する
+// ws が NULL でなければ，スレッドごとの作業領域を ws から使い回す
+int parallel_grasp_neighborhood_search(SCPinstance &inst,
+                                       SCPbitinstance *binst,
+                                       ListInstance *linst,
+                                       int K,
+                                       double alpha,
+                                       int niter,
+                                       int nrestart,
+                                       int nthreads,
+                                       uint64_t seed,
+                                       std::vector<SCPsolution>& Result,
+                                       SearchControl& ctl,
+                                       const SCPsolution* warm = NULL,
+                                       int nelite = 0,
+                                       SCPconstruction construction = CONSTRUCT_GRASP,
+                                       SCPcheckpoint* ckpt = NULL,
+                                       SearchWorkspaces* ws = NULL);
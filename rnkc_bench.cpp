@@ -0,0 +1,400 @@
+#include "SCPv.hpp"
+#include "rnkc.hpp"
+#include "Profile.hpp"
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+using namespace std;
+
+//
+//  ベンチマーク
+//
+//  同梱のインスタンスについて K と乱数の種を変えて grasp_neighborhood_search を1スレッドで動かし，
+//    読み込み時間，GRASP の反復/秒，局所探索の交換の評価/秒，目標値に達するまでの時間，最終的なカバー数
+//  を JSON で書き出す．
+//
+//    % ./rnkc_bench --out bench.json
+//    % ./rnkc_bench --compare bench.json
+//
+//  --compare を付けると，保存しておいた結果と比べて遅くなった・悪くなったケースを表示し，
+//  一つでもあれば終了コード 1 で終わる．このとき --out がなければ結果は書き出さない．
+//
+
+// ベンチマークのケース
+struct BenchCase
+{
+  const char* instance;         // インスタンスのファイル
+  int K;
+  int niter;                    // GRASP の反復回数
+  int target;                   // 目標のカバー数（この値に達した時刻を記録）
+};
+
+// 目標値は，どの種でもほぼ到達できるくらいの値にしてある
+const BenchCase CASES[] = {
+  { "scp41.txt",    5, 1000,   48 },
+  { "scp41.txt",   10, 1000,   84 },
+  { "scp41.txt",   20, 1000,  143 },
+  { "scp51.txt",   10,  500,   90 },
+  { "scp51.txt",   30,  500,  184 },
+  { "scp51.txt",   50,  500,  200 },
+  { "scpnrg1.txt", 20,  100,  566 },
+  { "scpnrg1.txt", 50,  100,  912 },
+  { "scpnrg1.txt", 150, 100, 1000 },
+};
+
+const int SEEDS[] = { 1, 2, 3 };
+
+// graspで使う alpha の値（rnkc_main と同じ）
+const double alpha = 0.85;
+
+
+// 1回の実行の結果
+struct BenchResult
+{
+  string instance;
+  string engine;
+  string width;                 // list の添字の幅（bitset では "-"）
+  int K;
+  int seed;
+  int niter;
+  double load_ms;
+  long iterations;
+  long moves;
+  double search_ms;
+  int target;
+  double time_to_target_ms;     // 達しなかったら -1
+  int num_Cover;
+};
+
+
+// 経過時間（ミリ秒）
+double elapsed_ms(chrono::steady_clock::time_point t0)
+{
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+
+// 1回分を JSON の1行として書く
+void write_result(FILE* fp, const BenchResult& r, bool last)
+{
+  fprintf(fp, "  {\"instance\": \"%s\", \"engine\": \"%s\", \"width\": \"%s\", \"K\": %d, \"seed\": %d, \"niter\": %d, "
+          "\"load_ms\": %.3f, \"iterations\": %ld, \"search_ms\": %.3f, \"iter_per_s\": %.3f, "
+          "\"moves\": %ld, \"moves_per_s\": %.3f, \"target\": %d, \"time_to_target_ms\": %.3f, "
+          "\"num_Cover\": %d}%s\n",
+          r.instance.c_str(), r.engine.c_str(), r.width.c_str(), r.K, r.seed, r.niter,
+          r.load_ms, r.iterations, r.search_ms, r.iterations / (r.search_ms / 1000.0),
+          r.moves, r.moves / (r.search_ms / 1000.0), r.target, r.time_to_target_ms,
+          r.num_Cover, last ? "" : ",");
+}
+
+
+// JSON の1行から "key": の値を取り出す（rnkc_bench が書いた形式だけを読めればよい）
+bool json_number(const string& line, const char* key, double& value)
+{
+  string k = string("\"") + key + "\": ";
+  size_t p = line.find(k);
+  if (p == string::npos) return false;
+  value = strtod(line.c_str() + p + k.size(), NULL);
+  return true;
+}
+
+bool json_string(const string& line, const char* key, string& value)
+{
+  string k = string("\"") + key + "\": \"";
+  size_t p = line.find(k);
+  if (p == string::npos) return false;
+  size_t q = line.find('"', p + k.size());
+  if (q == string::npos) return false;
+  value = line.substr(p + k.size(), q - p - k.size());
+  return true;
+}
+
+
+// 保存しておいた結果を読む
+vector<BenchResult> read_results(const char* FileName)
+{
+  vector<BenchResult> results;
+  FILE* fp = fopen(FileName, "r");
+  if (fp == NULL)
+  {
+    printf("Cannot open %s\n", FileName);
+    exit(1);
+  }
+
+  char buf[4096];
+  while (fgets(buf, sizeof(buf), fp) != NULL)
+  {
+    string line = buf;
+    BenchResult r;
+    double K, seed, niter, iterations, moves, target, cover;
+    if (!json_string(line, "instance", r.instance)) continue;
+    if (!json_string(line, "engine", r.engine)) r.engine = "list";
+    if (!json_string(line, "width", r.width)) r.width = (r.engine == "list") ? "wide" : "-";
+    if (json_number(line, "K", K) && json_number(line, "seed", seed)
+        && json_number(line, "niter", niter) && json_number(line, "load_ms", r.load_ms)
+        && json_number(line, "iterations", iterations) && json_number(line, "search_ms", r.search_ms)
+        && json_number(line, "moves", moves) && json_number(line, "target", target)
+        && json_number(line, "time_to_target_ms", r.time_to_target_ms)
+        && json_number(line, "num_Cover", cover))
+    {
+      r.K = K; r.seed = seed; r.niter = niter; r.iterations = iterations;
+      r.moves = moves; r.target = target; r.num_Cover = cover;
+      results.push_back(r);
+    }
+  }
+  fclose(fp);
+  return results;
+}
+
+
+// (インスタンス, エンジン, K, 反復回数) ごとに種をまとめた値
+struct BenchSummary
+{
+  double load_ms = 0;
+  double search_ms = 0;
+  double target_ms = 0;
+  long iterations = 0;
+  long moves = 0;
+  int runs = 0;
+  int reached = 0;              // 目標値に達した回数
+};
+
+map<string, BenchSummary> summarize(const vector<BenchResult>& results)
+{
+  map<string, BenchSummary> sum;
+  for (const BenchResult& r : results)
+  {
+    BenchSummary& s = sum[r.instance + " " + r.engine + " K=" + to_string(r.K)
+                          + " n=" + to_string(r.niter)];
+    s.load_ms += r.load_ms;
+    s.search_ms += r.search_ms;
+    s.iterations += r.iterations;
+    s.moves += r.moves;
+    s.runs++;
+    if (r.time_to_target_ms >= 0)
+    {
+      s.reached++;
+      s.target_ms += r.time_to_target_ms;
+    }
+  }
+  return sum;
+}
+
+
+// 保存しておいた結果と比べる．悪くなったものの数を返す
+// 速さは種をまとめた値で，カバー数は種ごとに比べる
+int compare_results(const vector<BenchResult>& base,
+                    const vector<BenchResult>& cur,
+                    double tolerance)
+{
+  int nreg = 0;
+  map<string, BenchSummary> sb = summarize(base), sc = summarize(cur);
+
+  printf("%-36s %12s %12s %12s %12s\n", "case", "iter/s", "moves/s", "load_ms", "target_ms");
+  for (auto& it : sc)
+  {
+    if (sb.count(it.first) == 0) continue;
+    BenchSummary& b = sb[it.first];
+    BenchSummary& c = it.second;
+
+    double bi = b.iterations / (b.search_ms / 1000.0), ci = c.iterations / (c.search_ms / 1000.0);
+    double bm = b.moves / (b.search_ms / 1000.0), cm = c.moves / (c.search_ms / 1000.0);
+    double bl = b.load_ms / b.runs, cl = c.load_ms / c.runs;
+    double bt = b.reached ? b.target_ms / b.reached : -1, ct = c.reached ? c.target_ms / c.reached : -1;
+
+    printf("%-36s %+11.1f%% %+11.1f%% %+11.1f%% %+11.1f%%\n", it.first.c_str(),
+           100 * (ci / bi - 1), 100 * (cm / bm - 1), 100 * (cl / bl - 1),
+           (bt > 0 && ct >= 0) ? 100 * (ct / bt - 1) : 0.0);
+
+    if (ci < bi * (1 - tolerance))
+    {
+      printf("  REGRESSION: GRASP iterations/s %.1f -> %.1f\n", bi, ci);
+      nreg++;
+    }
+    if (cm < bm * (1 - tolerance))
+    {
+      printf("  REGRESSION: moves/s %.1f -> %.1f\n", bm, cm);
+      nreg++;
+    }
+    // 短い時間の計測は揺れるので，1ミリ秒未満の差は無視する
+    if (cl > bl * (1 + tolerance) && cl - bl > 1.0)
+    {
+      printf("  REGRESSION: load time %.3f ms -> %.3f ms\n", bl, cl);
+      nreg++;
+    }
+    if (c.reached * b.runs < b.reached * c.runs)
+    {
+      printf("  REGRESSION: reached the target in %d/%d runs (was %d/%d)\n",
+             c.reached, c.runs, b.reached, b.runs);
+      nreg++;
+    }
+    else if (bt > 0 && ct > bt * (1 + tolerance) && ct - bt > 1.0)
+    {
+      printf("  REGRESSION: time to target %.3f ms -> %.3f ms\n", bt, ct);
+      nreg++;
+    }
+  }
+
+  for (const BenchResult& c : cur)
+  {
+    for (const BenchResult& b : base)
+    {
+      if (b.instance == c.instance && b.engine == c.engine && b.K == c.K
+          && b.seed == c.seed && b.niter == c.niter && c.num_Cover < b.num_Cover)
+      {
+        printf("REGRESSION: %s %s K=%d seed=%d num_Cover %d -> %d\n", c.instance.c_str(),
+               c.engine.c_str(), c.K, c.seed, b.num_Cover, c.num_Cover);
+        nreg++;
+      }
+    }
+  }
+
+  return nreg;
+}
+
+
+// メイン関数
+int main(int argc, char** argv)
+{
+  const char* OutFile = NULL;
+  const char* BaseFile = NULL;
+  double tolerance = 0.10;
+  string engine = "list";
+  string widthName = "auto";
+  bool quick = false;
+
+  // オプション
+  //   --out F        : 結果を F に書く（既定は bench.json，--compare のときは書かない）
+  //   --compare F    : F の結果と比べる
+  //   --tolerance X  : 速さがこの割合より悪くなったら報告する（既定は 0.10）
+  //   --engine E     : list か bitset
+  //   --width W      : list の添字の幅（auto, compact, wide）
+  //   --quick        : 種を1つだけにして反復回数を 1/5 にする
+  for (int a = 1; a < argc; a++)
+  {
+    string opt = argv[a];
+    if (opt == "--out" && a + 1 < argc) OutFile = argv[++a];
+    else if (opt == "--compare" && a + 1 < argc) BaseFile = argv[++a];
+    else if (opt == "--tolerance" && a + 1 < argc) tolerance = atof(argv[++a]);
+    else if (opt == "--engine" && a + 1 < argc) engine = argv[++a];
+    else if (opt == "--width" && a + 1 < argc) widthName = argv[++a];
+    else if (opt == "--quick") quick = true;
+    else
+    {
+      cout << "Usage: ./rnkc_bench [--out F] [--compare F] [--tolerance X] [--engine E] [--width W] [--quick]" << endl;
+      return 1;
+    }
+  }
+  if (engine != "list" && engine != "bitset")
+  {
+    cout << "Unknown engine: " << engine << endl;
+    return 1;
+  }
+  if (widthName != "auto" && widthName != "compact" && widthName != "wide")
+  {
+    cout << "Unknown width: " << widthName << endl;
+    return 1;
+  }
+
+  // 比べる結果は先に読んでおく（--out と同じファイルでもよいように）
+  vector<BenchResult> base;
+  if (BaseFile != NULL) base = read_results(BaseFile);
+
+  vector<BenchResult> results;
+  int nseed = quick ? 1 : sizeof(SEEDS) / sizeof(SEEDS[0]);
+
+  for (const BenchCase& bc : CASES)
+  {
+    for (int si = 0; si < nseed; si++)
+    {
+      BenchResult r;
+      r.instance = bc.instance;
+      r.engine = engine;
+      r.K = bc.K;
+      r.seed = SEEDS[si];
+      r.niter = quick ? max(1, bc.niter / 5) : bc.niter;
+      r.target = bc.target;
+
+      // 読み込みの時間も毎回計る
+      chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+      SCPinstance inst(bc.instance);
+      r.load_ms = elapsed_ms(t0);
+
+      SCPbitinstance* binst = (engine == "bitset") ? new SCPbitinstance(inst) : NULL;
+
+      SCPwidth width = select_width(inst);
+      if (widthName != "auto") width = (widthName == "compact") ? WIDTH_COMPACT : WIDTH_WIDE;
+      if (!width_fits(inst, width))
+      {
+        printf("%s is too large for width %s\n", bc.instance, widthName.c_str());
+        return 1;
+      }
+      r.width = (binst == NULL) ? width_name(width) : "-";
+      ListInstance* linst = (binst == NULL) ? new ListInstance(inst, width, false, r.K) : NULL;
+
+      // 1スレッド・再スタート1回で動かす
+      SearchControl ctl;
+      vector<SCPsolution> Result(1, SCPsolution(inst, r.K));
+      parallel_grasp_neighborhood_search(inst, binst, linst, r.K, alpha, r.niter, 1, 1,
+                                         r.seed, Result, ctl);
+      r.search_ms = ctl.elapsed_ms();
+      delete binst;
+      delete linst;
+      SCPsolution& best = Result[0];
+
+      r.iterations = ctl.Iterations.load();
+      r.moves = ctl.Moves.load();
+      r.num_Cover = check_number_of_covered_elements(inst, best);
+      r.time_to_target_ms = -1;
+      for (Improvement& imp : ctl.Trajectory)
+      {
+        if (imp.num_Cover >= r.target)
+        {
+          r.time_to_target_ms = imp.time_ms;
+          break;
+        }
+      }
+
+      printf("%s K=%d seed=%d: %d covered, %.1f iter/s, %.1f moves/s, load %.3f ms\n",
+             r.instance.c_str(), r.K, r.seed, r.num_Cover,
+             r.iterations / (r.search_ms / 1000.0), r.moves / (r.search_ms / 1000.0), r.load_ms);
+      results.push_back(r);
+    }
+  }
+
+  // 計測の結果（PROFILE=1 でビルドしたときだけ）
+  profile_report(stderr);
+
+  if (OutFile == NULL && BaseFile == NULL) OutFile = "bench.json";
+  if (OutFile != NULL)
+  {
+    FILE* fp = fopen(OutFile, "w");
+    if (fp == NULL)
+    {
+      printf("Cannot open %s\n", OutFile);
+      return 1;
+    }
+    fprintf(fp, "{\"benchmark\": \"rnkc\", \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++) write_result(fp, results[i], i + 1 == results.size());
+    fprintf(fp, "]}\n");
+    fclose(fp);
+  }
+
+  if (BaseFile != NULL)
+  {
+    int nreg = compare_results(base, results, tolerance);
+    if (nreg > 0)
+    {
+      printf("%d regression(s) against %s\n", nreg, BaseFile);
+      return 1;
+    }
+    printf("No regression against %s\n", BaseFile);
+  }
+
+  return 0;
+}
@@ -1,4 +1,13 @@
 #include "SCPv.hpp"
+#include "ScoreBucket.hpp"
+#include "SCPbitset.hpp"
+#include "SearchControl.hpp"
+#include "rnkc.hpp"
+#include "Island.hpp"
+#include "SCPstream.hpp"
+#include "LagrangeBound.hpp"
+#include "BranchBound.hpp"
+#include "Profile.hpp"
 //#include "Random.hpp"
 #include <cstdlib>
 #include <iostream>
@@ -7,370 +16,754 @@
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <cstring>
+#include <memory>
 using namespace std;
 
 // greedy_neighborhood_search で使う繰り返しの回数
 //int niter = 1000;
 int niter = 1000;
 
+// grasp_neighborhood_search を繰り返す回数（再スタートの回数）
+int nrestart = 20;
+
+// 並列に動かすスレッドの数
+int nthreads = 1;
+
 // graspで使う alpha の値
 double alpha = 0.85;
 
+// エリート解のプールの大きさ（0 なら path relinking をしない）
+int nelite = 0;
+
+// GRASP の反復で初期解を作る方法
+SCPconstruction construction = CONSTRUCT_GRASP;
+
 
-// 解csがカバーする要素数を返す
-int check_number_of_covered_elements(SCPinstance& inst,
-                                     SCPsolution& cs)
+
+// --k-range：K を Kfrom から Kto まで1ずつ変えて解き，K ごとに
+//   k,K,初期解のカバー数,カバー数,ミリ秒,反復回数
+// を1行表示する．最初の K は通常どおり探索する．以降の K は直前の K の最良解に
+// 1列足した（K が減るときは1列除いた）解を初期解にして，再スタート1回の短い探索をする．
+// 時間制限は K ごとにかける．linst は全ての K で共有する．
+void k_range_search(SCPinstance &inst,
+                    SCPbitinstance *binst,
+                    ListInstance *linst,
+                    int Kfrom,
+                    int Kto,
+                    double timeLimit,
+                    uint64_t seed)
 {
-  int cov = 0;
-  vector<int> covered(inst.numRows, 0);
-  for (int c : cs.CS)
-  {
-    if (c > inst.numColumns) continue;
-    for (int r : inst.ColEntries[c])
-    {
-      covered[r]++;
-    }
-  }
+  int step = (Kfrom <= Kto) ? 1 : -1;
+  SCPsolution prev(inst, Kfrom);  // 直前の K の最良解
 
-  for (int r = 0; r < inst.numRows; r++)
+  for (int K = Kfrom; ; K += step)
   {
-    if (cs.COVERED[r] == covered[r] && covered[r] > 0) cov++;
-    else if (cs.COVERED[r] != covered[r])
+    SearchControl ctl;
+    int nr = (K == Kfrom) ? nrestart : 1;
+    int ni = niter;
+    if (timeLimit > 0)
     {
-      printf("cs.COVERED[%d] = %d but covered[%d] = %d\n", r, cs.COVERED[r], r, covered[r]);
+      ctl.set_time_limit(timeLimit);
+      nr = 1;
+      ni = INT_MAX;
     }
-  }
 
-  if (cov == cs.num_Cover) return cov;
-  else
-  {
-    printf("The candidate solution covers %d elements, but our program coveres %d elements\n", cov, cs.num_Cover);
-    exit(1);
+    SCPsolution warm(inst, K);
+    if (K != Kfrom) resize_solution(inst, prev, warm);
+
+    vector<SCPsolution> Result(nr * nthreads, SCPsolution(inst, K));
+    int best = parallel_grasp_neighborhood_search(inst, binst, linst, K, alpha, ni, nr,
+                                                  nthreads, seed, Result, ctl,
+                                                  (K == Kfrom) ? NULL : &warm, nelite, construction);
+    check_number_of_covered_elements(inst, Result[best]);
+    printf("k,%d,%d,%d,%.3f,%ld\n", K, warm.num_Cover, Result[best].num_Cover,
+           ctl.elapsed_ms(), ctl.Iterations.load());
+
+    prev.swap(Result[best]);
+    if (K == Kto) break;
   }
 }
 
 
 
-// 列cを解に追加したときのscoreの更新
-void add_update_score(SCPinstance& inst,
-                      SCPsolution& cs,
-                      int c,
-                      vector<int>& score)
+// --island I:N：N 個の島のうち島 I として探索し，migrate 回の反復ごとに最良解を他の島と交換する．
+// 受け取った解がこの島の最良解より良ければ，次の探索はその解から（そうでなければ
+// この島の最良解から）局所探索を始める．島ごとに
+//   island,島の番号,エポック,受け取った最良のカバー数,エポックのカバー数,島の最良のカバー数,ミリ秒,反復回数
+// を1行表示する．時間制限がなければ反復回数の合計が niter * nrestart になるまで続ける．
+// 目標値に達したら（目標値に達した解を受け取ったときも）終わる．最良解は best に入る．
+void island_search(SCPinstance &inst,
+                   SCPbitinstance *binst,
+                   ListInstance *linst,
+                   int K,
+                   int id,
+                   int n,
+                   const string &dir,
+                   int migrate,
+                   double timeLimit,
+                   int target,
+                   uint64_t seed,
+                   SCPsolution &best)
 {
-  score[c] = -score[c];
-  // スコア更新
-  for (int r : inst.ColEntries[c]) // 列cがカバーする行
+  IslandLink link(dir, id, n);
+  SearchControl total;          // 島全体の時間
+  SCPsolution migrant(inst, K); // 受け取った中で最良の解
+  vector<SCPsolution> Result(nthreads, SCPsolution(inst, K));
+  long budget = (long)niter * nrestart;
+  long iters = 0;
+
+  // エポックごとの乱数の種（島ごとに別の系列にする）
+  mt19937_64 seeds = thread_random_engine(seed, id);
+
+  for (int epoch = 1; ; epoch++)
   {
-    // r行が初めてカバーされたら，rを含む行のスコアを減少
-    if (cs.COVERED[r] == 1)
+    SearchControl ctl;
+    ctl.Target = target;
+    int ni = migrate;
+    if (timeLimit > 0)
     {
-      for (int rc : inst.RowCovers[r])
-      {
-        if (rc != c) score[rc]--;
-      } // End: for ri
-    } // End if covered[r] == 1
-
-    // r行が2回カバーされたら，rを含むCSの要素のスコアを増加
-    if (cs.COVERED[r] == 2)
+      double rest = timeLimit - total.elapsed_ms();
+      if (rest <= 0) break;
+      ctl.set_time_limit(rest);
+    }
+    else
     {
-      for (int rc : inst.RowCovers[r]) // r行をカバーする列
-      {
-        if (cs.SOLUTION[rc] && rc != c)
-        {
-          score[rc]++;
-          break;
-        }
-      }
-    } // End if covered[r] == 2
-  }
-}
+      if (iters >= budget) break;
+      ni = (int)min((long)migrate, budget - iters);
+    }
 
+    // 他の島から届いた解
+    link.receive_best(inst, migrant);
+    if (target > 0 && migrant.num_Cover >= target)
+    {
+      if (best.num_Cover < migrant.num_Cover) best = migrant;
+      break;
+    }
+    const SCPsolution *warm = NULL;
+    if (best.num_Cover < migrant.num_Cover) warm = &migrant;
+    else if (best.num_Cover > 0) warm = &best;
 
-// 列cを解に追加したときのscoreの更新
-void remove_update_score(SCPinstance& inst,
-                         SCPsolution& cs,
-                         int c,
-                         vector<int>& score)
-{
-  score[c] = -score[c];
+    int b = parallel_grasp_neighborhood_search(inst, binst, linst, K, alpha, ni, 1, nthreads,
+                                               seeds(), Result, ctl, warm, nelite, construction);
+    iters += ctl.Iterations.load();
 
-  // スコア更新
-  for (int r : inst.ColEntries[c]) // 列cがカバーする行
-  {
-    // r行がカバーされなくなったら，rを含む行のスコアを増加
-    if (cs.COVERED[r] == 0)
+    // 良くなったら他の島に送る
+    if (best.num_Cover < Result[b].num_Cover)
     {
-      for (int rc : inst.RowCovers[r]) // r行をカバーする列
-      {
-        if (rc != c) score[rc]++;
-      } // End: for ri
-    } // End if covered[r] == 0
+      best = Result[b];
+      link.send_solution(best);
+    }
+    printf("island,%d,%d,%d,%d,%d,%.3f,%ld\n", id, epoch, migrant.num_Cover, Result[b].num_Cover,
+           best.num_Cover, total.elapsed_ms(), iters);
+    fflush(stdout);
 
-    // r行が1回カバーされたら，rを含むCSの要素のスコアを減少
-    if (cs.COVERED[r] == 1)
-    {
-      for (int rc : inst.RowCovers[r]) // r行をカバーする列
-      {
-        if (cs.SOLUTION[rc])
-        {
-          score[rc]--;
-          break;
-        }
-      }
-    } // End if covered[r] == 1
+    if (ctl.reached_target()) break;
   }
 }
 
 
-// 候補解csに含まれてない中で，スコア最大の列を返す
-int get_column_maxscore(SCPinstance& inst,
-                        SCPsolution& CS,
-                        vector<int>& score,
-                        mt19937_64& rnd)
-{
-  std::vector<int> maxCols;
-  int maxScore = 0, maxc = 0;
 
-  for (int c = 0; c < inst.numColumns; c++)
+// --stream：バイナリ形式のファイルから列を1列ずつ読み，sieve-streaming で K 列を選ぶ．
+// インスタンス全体は読み込まない．
+//   stream,行数,列数,非零要素の数,v の数,カバー数,ミリ秒
+// を表示する．nsample > 0 なら，読みながら列を nsample 個ランダムに選んでおき（reservoir sampling），
+// 2回目に読むときに選んだ K 列と合わせた部分インスタンスを作って，選んだ K 列から
+// GRASP と局所探索で改善する（行は全て残すので，カバー数は元のインスタンスと同じ）．
+//   refine,部分インスタンスの列数,カバー数,ミリ秒
+// を表示する（部分インスタンスが K 列に満たないときは改善しない）．戻り値はカバー数
+int stream_search(const char *FileName,
+                  int K,
+                  double eps,
+                  int nsample,
+                  double timeLimit,
+                  uint64_t seed)
+{
+  SearchControl total;
+  SCPcolumnStream stream(FileName);
+  SieveStreaming sieve(stream.numRows, K, eps);
+  mt19937_64 rnd = thread_random_engine(seed, 0);
+
+  vector<int> sample;           // 選んだ列（reservoir sampling）
+  sample.reserve(nsample);
+  vector<int> rows;
+  int j;
+  long n = 0;
+  while (stream.next(j, rows))
   {
-    if (CS.SOLUTION[c]) { continue; }
-
-    // 最大スコアの列をチェック
-    if (maxScore < score[c])
+    sieve.add(j, rows);
+    if (nsample > 0)
     {
-      maxScore = score[c];
-      maxCols.clear();
-      maxCols.push_back(c);
+      n++;
+      if ((int)sample.size() < nsample) sample.push_back(j);
+      else
+      {
+        long p = rnd() % n;
+        if (p < nsample) sample[p] = j;
+      }
     }
-    else if (maxScore == score[c])
-      maxCols.push_back(c);
-  } // End for c
-
-  if (maxCols.size() == 1) maxc = maxCols[0];
-  else
-  {
-    int j = rnd() % maxCols.size();
-    maxc = maxCols[j];
   }
 
-  return maxc;
-}
-
-
-// 候補解csに含まれてない中で，スコア最大の列を返す
-int get_column_grasp(SCPinstance& inst,
-                     SCPsolution& CS,
-                     vector<int>& score,
-                     double alpha,
-                     mt19937_64& rnd)
-{
-  int c;
-  int maxScore = score[0];
-  int minScore = score[0];
-  for (int c = 1; c < inst.numColumns; c++)
+  const SieveStreaming::Sieve *s = sieve.best();
+  int cover = (s == NULL) ? 0 : s->cover;
+  printf("stream,%d,%d,%ld,%d,%d,%.3f\n", stream.numRows, stream.numColumns, stream.numEntries,
+         (int)sieve.Sieves.size(), cover, total.elapsed_ms());
+  if (nsample == 0 || s == NULL) return cover;
+
+  // 部分インスタンスの列（元の列番号の昇順）．2回目に読むときに行を集める
+  vector<int> subId(s->cols.begin(), s->cols.end());
+  subId.insert(subId.end(), sample.begin(), sample.end());
+  sort(subId.begin(), subId.end());
+  subId.erase(unique(subId.begin(), subId.end()), subId.end());
+  // 部分インスタンスが K 列に満たなければ（列の少ないインスタンス）改善せずに sieve の解を返す
+  if ((int)subId.size() < K) return cover;
+
+  vector<vector<int>> Columns(subId.size());
+  stream.rewind();
+  size_t p = 0;
+  while (p < subId.size() && stream.next(j, rows))
   {
-    if (maxScore < score[c]) maxScore = score[c];
-    else if (minScore > score[c]) minScore = score[c];
+    if (j == subId[p]) Columns[p++].swap(rows);
   }
-
-  std::vector<int> Cols;
-
-  for (int c = 0; c < inst.numColumns; c++)
+  SCPinstance sub(stream.numRows, Columns);
+  Columns.clear();
+  ListInstance linst(sub, select_width(sub), false, K);
+
+  // sieve-streaming の解から始める
+  SCPsolution warm(sub, K);
+  for (int c : s->cols)
+    warm.add_column(sub, lower_bound(subId.begin(), subId.end(), c) - subId.begin());
+
+  SearchControl ctl;
+  int ni = niter;
+  if (timeLimit > 0)
   {
-    if (CS.SOLUTION[c]) { continue; }
-
-    // 最大スコアの列をチェック
-    if (score[c] >= minScore + alpha * (maxScore - minScore))
-    {
-      Cols.push_back(c);
-    }
-  } // End for c
-
-  int j = rnd() % Cols.size();
-  c = Cols[j];
-
-  return c;
+    ctl.set_time_limit(max(1.0, timeLimit - total.elapsed_ms()));
+    ni = INT_MAX;
+  }
+  vector<SCPsolution> Result(nthreads, SCPsolution(sub, K));
+  int b = parallel_grasp_neighborhood_search(sub, NULL, &linst, K, alpha, ni, 1, nthreads, seed,
+                                             Result, ctl, &warm, nelite, construction);
+  check_number_of_covered_elements(sub, Result[b]);
+  printf("refine,%d,%d,%.3f\n", sub.numColumns, Result[b].num_Cover, total.elapsed_ms());
+  return Result[b].num_Cover;
 }
 
 
 
-// 貪欲法：スコア最大の列をK列選ぶ
-// 引数の cs に結果が入る
-void greedy_construction(SCPinstance& inst,
-                         SCPsolution& cs,
-                         vector<int>& score,
-                         mt19937_64& rnd)
+// --exact：GRASP（再スタート1回，niter 回の反復）の解を暫定解にして，分枝限定法で最適解を求める．
+//   warm,暫定解のカバー数,ミリ秒
+//   exact,カバー数,optimal（最適性を証明した）か timeout,調べた節点の数,ミリ秒
+// を表示する．時間制限は分枝限定法にかける．init が NULL でなければ GRASP はその解から始める．
+// 最良解は best に入る．
+void exact_search(SCPinstance &inst,
+                  SCPbitinstance *binst,
+                  ListInstance *linst,
+                  int K,
+                  double timeLimit,
+                  uint64_t seed,
+                  const SCPsolution *init,
+                  SCPsolution &best)
 {
-  int maxc;
-
-  cs.initialize(inst);
-  for (int k = 0; k < cs.K; k++)
-  {
-    maxc = get_column_maxscore(inst, cs, score, rnd);
-    cs.add_column(inst, maxc);
-    // スコアの更新
-    add_update_score(inst, cs, maxc, score);
-  } // End for k
+  SearchControl total;
+  vector<SCPsolution> Result(nthreads, SCPsolution(inst, K));
+  SearchControl warmCtl;
+  int b = parallel_grasp_neighborhood_search(inst, binst, linst, K, alpha, niter, 1, nthreads,
+                                             seed, Result, warmCtl, init, nelite, construction);
+  printf("warm,%d,%.3f\n", Result[b].num_Cover, total.elapsed_ms());
+
+  // 分枝限定法はビット集合を使う（bitset のときはそれを使う）
+  SCPbitinstance *bits = (binst != NULL) ? binst : new SCPbitinstance(inst);
+  SCPbranchbound bb(*bits, K);
+  bb.set_incumbent(Result[b]);
+
+  SearchControl ctl;
+  if (timeLimit > 0) ctl.set_time_limit(timeLimit);
+  bool optimal = bb.solve(nthreads, ctl);
+  bb.to_solution(inst, best);
+  printf("exact,%d,%s,%ld,%.3f\n", best.num_Cover, optimal ? "optimal" : "timeout",
+         bb.Nodes.load(), total.elapsed_ms());
+  if (bits != binst) delete bits;
 }
 
 
-// GRASP法：スコアが alpha * (最大値 - 最小値) 以上である列からランダムに一つ選ぶ
-SCPsolution grasp_construction(SCPinstance &inst,
-                               int K,
-                               vector<int>& score,
-                               double alpha,
-                               mt19937_64& rnd)
-{
-  SCPsolution cs(inst, K);
-  int c;
-  for (int k = 0; k < cs.K; k++)
-  {
-    c = get_column_grasp(inst, cs, score, alpha, rnd);
-    cs.add_column(inst, c);
-    add_update_score(inst, cs, c, score);
-  } // End for k
-
-
-  return cs;
-}
-
 
-// 配列の順序をランダムに入れ替える
-void random_permutation(vector<int>& A,
-                        mt19937_64& rnd)
+// --save：最良解をファイルに書く（FileName が NULL なら何もしない）
+static void save_best(const char *FileName, SCPsolution &cs)
 {
-  int n = A.size();
-  int j;
-  for (int i = 0; i < n-1; ++i)
-  {
-    j = rnd() % (n-i);
-    swap(A[i], A[i+j]);
-  }
+  if (FileName != NULL && !write_solution(FileName, cs))
+    cout << "Cannot write the solution: " << FileName << endl;
 }
 
 
-// 単純な改善法
-// 引数の cs に結果が入る
-void simple_neighborhood_search(SCPinstance &inst,
-                                SCPsolution &cs,
-                                vector<int>& score,
-                                mt19937_64& rnd)
-{
-  int K = cs.K;
-  int c1, cov1;
-  int c2, cov2;
 
-  vector<int> idx = cs.CS;
-  random_permutation(idx, rnd);
-  cov1 = cs.num_Cover;
+// メイン関数
+int main(int argc, char** argv)
+{
+  //コマンドライン引数の数が少なければ強制終了
+  if (argc < 3){
+    cout << "Usage: ./command filename K(int)" << endl;
+    cout << "       ./command filename --k-range Kfrom:Kto" << endl;
+    return 0;
+  }
+  SearchControl ctl;            // 時間は読み込みも含めて数える
+  char *FileName = argv[1];
 
-  for (int i = 0; i < K; ++i)
+  // --k-range のときは K を省略できる
+  int K = 0;
+  int firstOpt = 2;
+  if (argv[2][0] != '-')
   {
-    c1 = idx[i];
-    cs.remove_column(inst, c1);
+    K = atoi(argv[2]);
+    firstOpt = 3;
+  }
 
-    // 最大スコアの列
-    c2 = get_column_maxscore(inst, cs, score, rnd);
-    cs.add_column(inst, c2);
-    add_update_score(inst, cs, c2, score);
-    cov2 = cs.num_Cover;
-    if (cov1 > cov2)
+  std::random_device rnd;    // 非決定的な乱数生成器
+  uint64_t seed = ((uint64_t)rnd() << 32) | rnd();
+
+  // オプション
+  //   --threads N : N 個のスレッドで並列に探索する
+  //   --seed S    : 乱数の種を固定する（同じスレッド数なら同じ結果になる）
+  //   --engine E  : list（隣接リストとスコアの差分更新，既定）か
+  //                 bitset（行のビット集合と SIMD popcount，密なインスタンス向け）
+  //   --time-limit T : T ミリ秒で打ち切る（反復回数・再スタート回数の制限はなくなる）
+  //   --target C  : カバー数が C に達したら打ち切る
+  //   --width W   : list の添字の幅．auto（既定，インスタンスから選ぶ），
+  //                 compact（uint16_t の添字と uint8_t の被覆回数）か wide（int）
+  //   --k-range A:B : K = A, A±1, ..., B を順に解く（k_range_search）
+  //   --reduce    : list で，重複する行をまとめ支配される列を除いてから探索する
+  //   --reorder   : list で，行と列の番号をキャッシュに合わせて付け替えてから探索する（結果の列番号は元のまま）
+  //   --elite N   : list で，局所最適解を N 個までエリート解として残し，path relinking をする
+  //   --construction C : 初期解を作る方法．grasp（既定），greedy（貪欲法），
+  //                 lazy（bitset のみ．遅延評価の貪欲法で，greedy と同じ解を gain の計算を減らして作る）
+  //   --island I:N : N 個の島のうち島 I として探索し，最良解を他の島と交換する（island_search）
+  //   --island-dir D : 島どうしの通信に使うソケットを置くディレクトリ（既定 /tmp）
+  //   --migrate M : 島で M 回の反復ごとに解を交換する（既定 100）
+  //   --stream    : バイナリ形式のファイルから列を1列ずつ読んで解く（stream_search）
+  //   --epsilon E : --stream の sieve-streaming の精度（既定 0.1）
+  //   --sample M  : --stream で M 列（M >= K）を選んだ部分インスタンスで解を改善する（既定 0 は改善しない）
+  //   --bound N   : 劣勾配法を N 回までしてラグランジュ緩和の上界を求め，最良解が上界に
+  //                 達したら（最適解が見つかったら）打ち切る．上界と最良解の差を表示する
+  //   --bound-thread : --bound の上界を探索の前ではなく，探索と並行して別のスレッドで求める
+  //   --exact     : GRASP の解から分枝限定法で最適解を求める（exact_search．小さいインスタンス向け）
+  //   --checkpoint F : 探索の途中の状態（各スレッドの乱数・反復の数・最良解）をファイル F に保存する
+  //   --checkpoint-interval T : T ミリ秒ごとに保存する（既定 60000）
+  //   --resume    : --checkpoint のファイルがあれば，そこから続ける（なければ最初から）
+  //   --init F    : ファイル F の解（1から数えた列番号）を最初の局所探索の初期解にする
+  //                 （--elite ならエリート解のプールにも入れる．列数が K でなければ足し引きする）
+  //   --save F    : 最良解の列番号をファイル F に書く（--init で読める形式）
+  string engine = "list";
+  bool reduce = false;
+  bool reorder = false;
+  string widthName = "auto";
+  int Kfrom = 0, Kto = 0;
+  int islandId = 0, nIslands = 0;
+  string islandDir = "/tmp";
+  int migrate = 100;
+  bool streaming = false;
+  double eps = 0.1;
+  int nsample = 0;
+  double timeLimit = 0;
+  int nbound = 0;
+  bool boundThread = false;
+  bool exact = false;
+  string checkpointFile;
+  double checkpointInterval = 60000;
+  bool resume = false;
+  const char *initFile = NULL;
+  const char *saveFile = NULL;
+  for (int a = firstOpt; a < argc; a++)
+  {
+    string opt = argv[a];
+    if (opt == "--threads" && a + 1 < argc) nthreads = max(1, atoi(argv[++a]));
+    else if (opt == "--seed" && a + 1 < argc) seed = strtoull(argv[++a], NULL, 10);
+    else if (opt == "--engine" && a + 1 < argc) engine = argv[++a];
+    else if (opt == "--time-limit" && a + 1 < argc) timeLimit = atof(argv[++a]);
+    else if (opt == "--target" && a + 1 < argc) ctl.Target = atoi(argv[++a]);
+    else if (opt == "--width" && a + 1 < argc) widthName = argv[++a];
+    else if (opt == "--reduce") reduce = true;
+    else if (opt == "--reorder") reorder = true;
+    else if (opt == "--elite" && a + 1 < argc) nelite = max(0, atoi(argv[++a]));
+    else if (opt == "--construction" && a + 1 < argc)
+    {
+      string name = argv[++a];
+      if (name == "grasp") construction = CONSTRUCT_GRASP;
+      else if (name == "greedy") construction = CONSTRUCT_GREEDY;
+      else if (name == "lazy") construction = CONSTRUCT_LAZY;
+      else
+      {
+        cout << "Unknown construction: " << name << endl;
+        return 1;
+      }
+    }
+    else if (opt == "--island-dir" && a + 1 < argc) islandDir = argv[++a];
+    else if (opt == "--stream") streaming = true;
+    else if (opt == "--epsilon" && a + 1 < argc) eps = atof(argv[++a]);
+    else if (opt == "--sample" && a + 1 < argc) nsample = max(0, atoi(argv[++a]));
+    else if (opt == "--bound" && a + 1 < argc) nbound = max(0, atoi(argv[++a]));
+    else if (opt == "--bound-thread") boundThread = true;
+    else if (opt == "--exact") exact = true;
+    else if (opt == "--checkpoint" && a + 1 < argc) checkpointFile = argv[++a];
+    else if (opt == "--checkpoint-interval" && a + 1 < argc) checkpointInterval = max(0.0, atof(argv[++a]));
+    else if (opt == "--resume") resume = true;
+    else if (opt == "--init" && a + 1 < argc) initFile = argv[++a];
+    else if (opt == "--save" && a + 1 < argc) saveFile = argv[++a];
+    else if (opt == "--migrate" && a + 1 < argc) migrate = max(1, atoi(argv[++a]));
+    else if (opt == "--island" && a + 1 < argc)
+    {
+      if (sscanf(argv[++a], "%d:%d", &islandId, &nIslands) != 2 ||
+          nIslands < 1 || islandId < 0 || islandId >= nIslands)
+      {
+        cout << "Bad island: " << argv[a] << endl;
+        return 1;
+      }
+    }
+    else if (opt == "--k-range" && a + 1 < argc)
     {
-      cs.remove_column(inst, c2);
-      remove_update_score(inst, cs, c2, score);
-      cs.add_column(inst, c1);
-      add_update_score(inst, cs, c1, score);
+      if (sscanf(argv[++a], "%d:%d", &Kfrom, &Kto) != 2 || Kfrom < 1 || Kto < 1)
+      {
+        cout << "Bad K range: " << argv[a] << endl;
+        return 1;
+      }
     }
     else
     {
-      cov1 = cs.num_Cover;
+      cout << "Unknown option: " << opt << endl;
+      return 1;
     }
-  } // End for i
-
-}
-
+  }
 
-// GRASP初期解＋単純局所探索を niter 回繰り返し
-SCPsolution grasp_neighborhood_search(SCPinstance &inst,
-                                      int K,
-                                      double alpha,
-                                      int niter,
-                                      mt19937_64& rnd)
-{
-  SCPsolution cs(inst, K);
-  SCPsolution best_cs(inst, K);
-  vector<int> score(inst.numColumns, 0);
+  if (Kfrom > 0 && ctl.Target > 0)
+  {
+    cout << "--target cannot be used with --k-range" << endl;
+    return 1;
+  }
+  if (Kfrom > 0 && nIslands > 0)
+  {
+    cout << "--island cannot be used with --k-range" << endl;
+    return 1;
+  }
+  if (nbound > 0 && (Kfrom > 0 || nIslands > 0 || streaming))
+  {
+    cout << "--bound cannot be used with --k-range, --island, --stream" << endl;
+    return 1;
+  }
+  if (exact && (Kfrom > 0 || nIslands > 0 || streaming || nbound > 0 || ctl.Target > 0))
+  {
+    cout << "--exact cannot be used with --k-range, --island, --stream, --bound, --target" << endl;
+    return 1;
+  }
+  if (!checkpointFile.empty() && (Kfrom > 0 || nIslands > 0 || streaming || exact))
+  {
+    cout << "--checkpoint cannot be used with --k-range, --island, --stream, --exact" << endl;
+    return 1;
+  }
+  if ((initFile != NULL || saveFile != NULL) && (Kfrom > 0 || streaming))
+  {
+    cout << "--init and --save cannot be used with --k-range, --stream" << endl;
+    return 1;
+  }
+  if (resume && checkpointFile.empty())
+  {
+    cout << "--resume needs --checkpoint" << endl;
+    return 1;
+  }
+  if (Kfrom == 0 && K < 1)
+  {
+    cout << "Usage: ./command filename K(int)" << endl;
+    return 1;
+  }
 
-  for (int iter = 1; iter <= niter; ++iter)
+  // インスタンスを読み込まずに，列を1列ずつ読んで解く
+  if (streaming)
   {
-    // スコアを初期化
-    for (int j = 0; j < inst.numColumns; j++)
+    if (Kfrom > 0 || nIslands > 0 || engine != "list" || reduce || reorder ||
+        construction == CONSTRUCT_LAZY || eps <= 0)
     {
-      score[j] = inst.ColEntries[j].size();
+      cout << "--stream cannot be used with --k-range, --island, --engine, --reduce, --reorder, "
+           << "--construction lazy (and needs --epsilon > 0)" << endl;
+      return 1;
     }
+    if (nsample > 0 && nsample < K)
+    {
+      cout << "--sample needs at least K columns" << endl;
+      return 1;
+    }
+    try
+    {
+      printf("%d\n", stream_search(FileName, K, eps, nsample, timeLimit, seed));
+    }
+    catch (DataException&)
+    {
+      cout << "--stream needs a binary instance (scp2bin): " << FileName << endl;
+      return 1;
+    }
+    profile_report(stderr);
+    return 0;
+  }
 
-    // 初期解を生成
-    cs = grasp_construction(inst, K, score, alpha, rnd);
+  // SCPのインスタンスを読み込む（scp2bin で変換したバイナリ形式も読める）
+  // 壊れたファイルは DataException になるので，メッセージを出して終わる
+  unique_ptr<SCPinstance> loaded;
+  try
+  {
+    loaded.reset(new SCPinstance(FileName));
+  }
+  catch (DataException&)
+  {
+    cout << "Failed to read the instance: " << FileName << endl;
+    return 1;
+  }
+  SCPinstance &inst = *loaded;
 
-    // 局所探索
-    simple_neighborhood_search(inst, cs, score, rnd);
+  SCPbitinstance *binst = NULL;
+  if (engine == "bitset") binst = new SCPbitinstance(inst);
+  else if (engine != "list")
+  {
+    cout << "Unknown engine: " << engine << endl;
+    return 1;
+  }
+  if (binst != NULL && reduce)
+  {
+    cout << "--reduce is supported only by the list engine" << endl;
+    return 1;
+  }
+  if (binst != NULL && reorder)
+  {
+    cout << "--reorder is supported only by the list engine" << endl;
+    return 1;
+  }
+  if (binst != NULL && nelite > 0)
+  {
+    cout << "--elite is supported only by the list engine" << endl;
+    return 1;
+  }
+  if (binst == NULL && construction == CONSTRUCT_LAZY)
+  {
+    cout << "--construction lazy is supported only by the bitset engine" << endl;
+    return 1;
+  }
 
-    if (best_cs.num_Cover < cs.num_Cover)
+  // 添字の幅は読み込んだインスタンスの大きさで決める
+  SCPwidth width = select_width(inst);
+  if (widthName == "compact" || widthName == "wide")
+  {
+    width = (widthName == "compact") ? WIDTH_COMPACT : WIDTH_WIDE;
+    if (!width_fits(inst, width))
     {
-      best_cs = cs;
+      cout << "The instance is too large for width " << widthName << endl;
+      return 1;
     }
-  } // End for iter
+  }
+  else if (widthName != "auto")
+  {
+    cout << "Unknown width: " << widthName << endl;
+    return 1;
+  }
 
-  return best_cs;
-}
+  // リスト版の探索で使うインスタンス（縮小するなら行数・列数の変化を表示）
+  ListInstance *linst = NULL;
+  if (binst == NULL)
+  {
+    linst = new ListInstance(inst, width, reduce, max(K, max(Kfrom, Kto)), reorder);
+    if (reduce)
+      printf("reduce,%d,%d,%d,%d\n", inst.numRows, inst.numColumns,
+             linst->numRows(), linst->numColumns());
+  }
+
+  // 初期解をファイルから読む：init,読んだ解のカバー数,飛ばした列番号の数
+  SCPsolution *init = NULL;
+  if (initFile != NULL)
+  {
+    init = new SCPsolution(inst, K);
+    try
+    {
+      int skipped = read_solution(inst, initFile, *init);
+      printf("init,%d,%d\n", init->num_Cover, skipped);
+    }
+    catch (DataException&)
+    {
+      cout << "Cannot read the solution: " << initFile << endl;
+      return 1;
+    }
+  }
 
+  // 島の一つとして解く（初期解があれば島の最良解にしておき，そこから始める）
+  if (nIslands > 0)
+  {
+    SCPsolution best(inst, K);
+    if (init != NULL) best = *init;
+    island_search(inst, binst, linst, K, islandId, nIslands, islandDir, migrate,
+                  timeLimit, ctl.Target, seed, best);
+    delete binst;
+    delete linst;
+    delete init;
+    if (check_number_of_covered_elements(inst, best))
+    {
+      printf("%d\n", best.num_Cover);
+      save_best(saveFile, best);
+    }
+    profile_report(stderr);
+    return 0;
+  }
 
+  // K を変えながら解く（インスタンスは1回だけ読む）
+  if (Kfrom > 0)
+  {
+    k_range_search(inst, binst, linst, Kfrom, Kto, timeLimit, seed);
+    delete binst;
+    delete linst;
+    profile_report(stderr);
+    return 0;
+  }
 
-// メイン関数
-int main(int argc, char** argv)
-{
-  //コマンドライン引数の数が少なければ強制終了
-  if (argc < 3){
-    cout << "Usage: ./command filename K(int)" << endl;
+  // 分枝限定法で最適解を求める
+  if (exact)
+  {
+    SCPsolution best(inst, K);
+    exact_search(inst, binst, linst, K, timeLimit, seed, init, best);
+    delete binst;
+    delete linst;
+    delete init;
+    if (check_number_of_covered_elements(inst, best))
+    {
+      printf("%d\n", best.num_Cover);
+      save_best(saveFile, best);
+    }
+    profile_report(stderr);
     return 0;
   }
-  char *FileName = argv[1];
-  FILE *SourceFile = fopen(FileName,"r");
-  int K = atoi(argv[2]);
 
-  // SCPのインスタンスを読み込む
-  SCPinstance  inst(SourceFile);
+  // 途中の状態を保存する．設定（乱数の種・K・スレッド数・反復回数など）が同じときだけ再開できる
+  SCPcheckpoint *ckpt = NULL;
+  if (!checkpointFile.empty())
+  {
+    uint64_t alphaBits, timeBits;
+    memcpy(&alphaBits, &alpha, sizeof(alphaBits));
+    memcpy(&timeBits, &timeLimit, sizeof(timeBits));
+    vector<uint64_t> settings = {
+      seed, (uint64_t)K, (uint64_t)nthreads, (uint64_t)nrestart, (uint64_t)niter, alphaBits, timeBits,
+      (uint64_t)nelite, (uint64_t)construction, (uint64_t)(binst != NULL), (uint64_t)width,
+      (uint64_t)reduce, (uint64_t)reorder, (uint64_t)inst.numRows, (uint64_t)inst.numColumns };
+    ckpt = new SCPcheckpoint(checkpointFile, checkpointInterval, settings, nthreads);
+    try
+    {
+      if (resume && ckpt->load())
+      {
+        long iters = 0;
+        for (ThreadCheckpoint &s : ckpt->Threads) iters += s.iterations;
+        printf("resume,%.3f,%ld\n", ckpt->ElapsedMs, iters);
+      }
+    }
+    catch (DataException&)
+    {
+      cout << "The checkpoint does not match this run: " << checkpointFile << endl;
+      return 1;
+    }
+  }
+
+  // 時間制限があれば，1回の再スタートで時間いっぱいまで反復する
+  // （再開したときは止まるまでの時間を引く）
+  if (timeLimit > 0)
+  {
+    ctl.set_time_limit(timeLimit - (ckpt != NULL ? ckpt->ElapsedMs : 0));
+    nrestart = 1;
+    niter = INT_MAX;
+  }
 
   // 候補解
-  SCPsolution CS(inst, K);
+  vector<SCPsolution> Result(nrestart * nthreads, SCPsolution(inst, K));
   SCPsolution Best_CS_glo(inst, K);
   // End Initialize;
 
-  std::random_device rnd;    // 非決定的な乱数生成器
-  std::mt19937_64 mt(rnd()); // メルセンヌ・ツイスタ
-  //std::mt19937_64 mt(0); // メルセンヌ・ツイスタ
+  // ラグランジュ緩和の上界（探索の前に求めるか，探索と並行して求める）
+  LagrangeBound *lb = NULL;
+  thread boundWorker;
+  if (nbound > 0)
+  {
+    lb = new LagrangeBound(inst, K);
+    if (boundThread) boundWorker = thread([&]() { lb->solve(inst, nbound, &ctl); });
+    else lb->solve(inst, nbound, &ctl);
+  }
+
+  int best = parallel_grasp_neighborhood_search(inst, binst, linst, K, alpha, niter, nrestart,
+                                                nthreads, seed, Result, ctl, init, nelite, construction, ckpt);
+  if (ckpt != NULL)
+  {
+    ckpt->write(ctl);
+    delete ckpt;
+  }
+  if (boundWorker.joinable())
+  {
+    lb->Cancel = true;
+    boundWorker.join();
+  }
+  delete binst;
+  delete linst;
 
+  // 上界：bound,上界,L(λ) の最小値,劣勾配法の反復回数
+  if (lb != NULL)
+    printf("bound,%d,%.3f,%d\n", lb->Bound, lb->Value, lb->nIter);
 
+  // 時間制限か目標値か上界があるときは，最良解が更新された時刻・反復・カバー数を表示
+  if (ctl.hasDeadline || ctl.Target > 0 || lb != NULL)
+  {
+    sort(ctl.Trajectory.begin(), ctl.Trajectory.end(),
+         [](const Improvement& a, const Improvement& b) { return a.num_Cover < b.num_Cover; });
+    for (Improvement& imp : ctl.Trajectory)
+    {
+      printf("improve,%.3f,%ld,%d\n", imp.time_ms, imp.iteration, imp.num_Cover);
+    }
+    printf("stop,%s,%.3f,%ld\n",
+           ctl.reached_target() ? "target" :
+           (ctl.reached_bound() ? "bound" : (ctl.Stopped ? "time" : "iterations")),
+           ctl.elapsed_ms(), ctl.Iterations.load());
+  }
 
-  // 何回か繰り返す
-  // Best_CS_glo が最良解
-  for (int i = 1; i <= 20; i++)
+  // 再スタートごとの結果
+  // Best_CS_glo はそこまでの最良解
+  for (int i = 1; i <= nrestart; i++)
   {
-    CS = grasp_neighborhood_search(inst, K, alpha, niter, mt);
+    int bi = (i - 1) * nthreads;
+    for (int t = 1; t < nthreads; t++)
+    {
+      if (Result[bi].num_Cover < Result[(i - 1) * nthreads + t].num_Cover)
+        bi = (i - 1) * nthreads + t;
+    }
+    if (Result[bi].num_Cover == 0) break;   // 打ち切られて実行されなかった
 
-    if (Best_CS_glo.num_Cover < CS.num_Cover)
+    if (Best_CS_glo.num_Cover < Result[bi].num_Cover)
     {
-      Best_CS_glo = CS;
+      Best_CS_glo = Result[bi];
     }
 
     //CS.print_solution();
     // 結果
-    printf("%d,%d,%d\n", i, CS.num_Cover, Best_CS_glo.num_Cover);
+    printf("%d,%d,%d\n", i, Result[bi].num_Cover, Best_CS_glo.num_Cover);
+  }
+
+  // 全体の最良解（カバー数が同じときは番号の小さい結果）
+  Best_CS_glo = Result[best];
+
+  // 上界との差：gap,上界,カバー数,差（0 なら最適解）
+  if (lb != NULL)
+  {
+    printf("gap,%d,%d,%d\n", lb->Bound, Best_CS_glo.num_Cover, lb->Bound - Best_CS_glo.num_Cover);
+    delete lb;
   }
 
   if (check_number_of_covered_elements(inst, Best_CS_glo))
   {
     printf("%d\n", Best_CS_glo.num_Cover);
+    save_best(saveFile, Best_CS_glo);
   }
+  delete init;
+
+  // 計測の結果（make PROFILE=1 でビルドしたときだけ）
+  profile_report(stderr);
   return 0;
 }
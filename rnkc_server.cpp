@@ -0,0 +1,322 @@
+//---------------------------------------------------------------------------
+// 最大 k 被覆問題を解くサーバ
+// 起動時にインスタンスを読み込んでおき，要求を1行ずつ受け取って解く．
+// 要求は標準入力か Unix ドメインソケット（--socket）から受け取り，ワーカーのスレッドで解く．
+// 同じインスタンスへの要求は，読み込んだインスタンス（SCPsolver）を共有する．
+// Araki
+//---------------------------------------------------------------------------
+#include "Solver.hpp"
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+using namespace std;
+
+// 反復回数で打ち切るときの反復回数（要求の時間が 0 のとき．rnkc_main の niter と同じ）
+int niter = 1000;
+
+
+// 1つの接続（標準入出力か，ソケット）
+// 応答はワーカーから書くので Mutex で1行ずつ書く．ソケットは最後の参照がなくなったら閉じる
+struct Connection
+{
+  int in, out;
+  mutex Mutex;
+
+  Connection(int in, int out) : in(in), out(out) {}
+  ~Connection() { if (in == out) close(in); }
+
+  // 1行書く（相手がいなくなっていたら捨てる）
+  void reply(const string &line)
+  {
+    lock_guard<mutex> lock(Mutex);
+    const char *p = line.data();
+    size_t n = line.size();
+    while (n > 0)
+    {
+      ssize_t w = write(out, p, n);
+      if (w < 0 && errno == EINTR) continue;
+      if (w <= 0) return;
+      p += w;
+      n -= w;
+    }
+  }
+};
+
+
+// 解く要求
+struct Request
+{
+  shared_ptr<Connection> conn;
+  string id;
+  SCPsolver *solver;
+  int K;
+  double timeMs;
+  uint64_t seed;
+};
+
+
+// ワーカーに渡す要求の待ち行列
+class RequestQueue
+{
+ public:
+  RequestQueue() : closed(false) {}
+
+  void push(Request &r)
+  {
+    {
+      lock_guard<mutex> lock(Mutex);
+      Queue.push_back(r);
+    }
+    Ready.notify_one();
+  }
+
+  // 要求を1つ取る．閉じていて空なら false
+  bool pop(Request &r)
+  {
+    unique_lock<mutex> lock(Mutex);
+    Ready.wait(lock, [this]() { return closed || !Queue.empty(); });
+    if (Queue.empty()) return false;
+    r = Queue.front();
+    Queue.pop_front();
+    return true;
+  }
+
+  // これ以上要求が来ない（残っている要求は解く）
+  void close()
+  {
+    {
+      lock_guard<mutex> lock(Mutex);
+      closed = true;
+    }
+    Ready.notify_all();
+  }
+
+ private:
+  mutex Mutex;
+  condition_variable Ready;
+  deque<Request> Queue;
+  bool closed;
+};
+
+
+// 読み込んだインスタンス（名前から）
+map<string, SCPsolver*> Instances;
+
+
+// 1行の要求
+//   <id> <インスタンスの名前> <K> <時間（ミリ秒）> <乱数の種>
+// を読んで待ち行列に入れる．時間が 0 なら niter 回の反復で打ち切る．
+// 形式が違えば，すぐに
+//   <id> error <理由>（bad request, unknown instance, bad K, bad time）
+// を返す．
+void handle_line(const string &line, shared_ptr<Connection> &conn, RequestQueue &q)
+{
+  istringstream in(line);
+  Request r;
+  string name;
+  if (!(in >> r.id)) return;    // 空行
+  if (!(in >> name >> r.K >> r.timeMs >> r.seed))
+  {
+    conn->reply(r.id + " error bad request\n");
+    return;
+  }
+  map<string, SCPsolver*>::iterator it = Instances.find(name);
+  if (it == Instances.end())
+  {
+    conn->reply(r.id + " error unknown instance " + name + "\n");
+    return;
+  }
+  r.solver = it->second;
+  if (r.K < 1 || r.K > r.solver->numColumns())
+  {
+    conn->reply(r.id + " error bad K\n");
+    return;
+  }
+  if (!isfinite(r.timeMs) || r.timeMs < 0)
+  {
+    conn->reply(r.id + " error bad time\n");
+    return;
+  }
+  r.conn = conn;
+  q.push(r);
+}
+
+
+// 接続から要求を1行ずつ読む（相手が閉じるまで）
+void read_requests(shared_ptr<Connection> conn, RequestQueue &q)
+{
+  string buf;
+  char chunk[4096];
+  for (;;)
+  {
+    ssize_t n = read(conn->in, chunk, sizeof(chunk));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    buf.append(chunk, n);
+    size_t start = 0, nl;
+    while ((nl = buf.find('\n', start)) != string::npos)
+    {
+      handle_line(buf.substr(start, nl - start), conn, q);
+      start = nl + 1;
+    }
+    buf.erase(0, start);
+  }
+  if (!buf.empty()) handle_line(buf, conn, q);
+}
+
+
+// ワーカー：要求を解いて
+//   <id> ok <カバー数> <ミリ秒> <列番号 × K（1から数える）>
+// を返す．解けなかったときは <id> error（ソルバの中の例外は internal）を返し，ワーカーは続ける
+void worker(RequestQueue &q)
+{
+  Request r;
+  while (q.pop(r))
+  {
+    string out;
+    try
+    {
+      long budget = (r.timeMs > 0) ? 0 : niter;
+      SCPsolveResult res = r.solver->solve(r.K, budget, r.seed, r.timeMs);
+      char head[64];
+      snprintf(head, sizeof(head), " ok %d %.3f", res.num_Cover, res.ElapsedMs);
+      out = r.id + head;
+      for (int c : res.Columns) out += " " + to_string(c + 1);
+      out += "\n";
+    }
+    catch (DataException&)
+    {
+      out = r.id + " error bad request\n";
+    }
+    catch (...)
+    {
+      out = r.id + " error internal\n";
+    }
+    r.conn->reply(out);
+    r = Request();              // 接続への参照を離す
+  }
+}
+
+
+// メイン関数
+int main(int argc, char** argv)
+{
+  // オプション
+  //   --socket P  : Unix ドメインソケット P で接続を待つ（なければ標準入力から読む）
+  //   --workers N : N 個の要求を同時に解く（既定 1）
+  //   --threads T : 1つの要求を T 個のスレッドで解く（既定 1）
+  // それ以外の引数は読み込むインスタンスで，名前=ファイル名 かファイル名（名前もファイル名）
+  string socketPath;
+  int nworkers = 1;
+  SCPsolverOptions opt;
+  vector<pair<string, string>> files;
+  for (int a = 1; a < argc; a++)
+  {
+    string arg = argv[a];
+    if (arg == "--socket" && a + 1 < argc) socketPath = argv[++a];
+    else if (arg == "--workers" && a + 1 < argc) nworkers = max(1, atoi(argv[++a]));
+    else if (arg == "--threads" && a + 1 < argc) opt.nthreads = max(1, atoi(argv[++a]));
+    else if (arg.compare(0, 2, "--") == 0)
+    {
+      cout << "Unknown option: " << arg << endl;
+      return 1;
+    }
+    else
+    {
+      size_t eq = arg.find('=');
+      if (eq == string::npos) files.push_back(make_pair(arg, arg));
+      else files.push_back(make_pair(arg.substr(0, eq), arg.substr(eq + 1)));
+    }
+  }
+  if (files.empty())
+  {
+    cout << "Usage: ./rnkc_server [--socket path] [--workers N] [--threads T] name=file ..." << endl;
+    return 0;
+  }
+
+  // インスタンスを読み込む：load,名前,行数,列数,ミリ秒（標準エラーに）
+  for (pair<string, string> &f : files)
+  {
+    SearchControl clock;
+    try
+    {
+      Instances[f.first] = new SCPsolver(f.second.c_str(), opt);
+    }
+    catch (DataException&)
+    {
+      cout << "Cannot read the instance: " << f.second << endl;
+      return 1;
+    }
+    fprintf(stderr, "load,%s,%d,%d,%.3f\n", f.first.c_str(), Instances[f.first]->numRows(),
+            Instances[f.first]->numColumns(), clock.elapsed_ms());
+  }
+
+  // 閉じた接続に書いても終わらないように
+  signal(SIGPIPE, SIG_IGN);
+
+  RequestQueue q;
+  vector<thread> workers;
+  for (int i = 0; i < nworkers; i++) workers.push_back(thread(worker, ref(q)));
+
+  if (socketPath.empty())
+  {
+    // 標準入力が閉じたら，残りの要求を解いてから終わる
+    read_requests(make_shared<Connection>(0, 1), q);
+  }
+  else
+  {
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path))
+    {
+      cout << "Socket path too long: " << socketPath << endl;
+      return 1;
+    }
+    strcpy(addr.sun_path, socketPath.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if (fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0)
+    {
+      cout << "Cannot listen on " << socketPath << ": " << strerror(errno) << endl;
+      return 1;
+    }
+
+    // 接続ごとに読むスレッドを作る（終わるまで待ち続ける）
+    for (;;)
+    {
+      int c = accept(fd, NULL, NULL);
+      if (c < 0)
+      {
+        if (errno == EINTR) continue;
+        cout << "accept: " << strerror(errno) << endl;
+        break;
+      }
+      thread(read_requests, make_shared<Connection>(c, c), ref(q)).detach();
+    }
+    close(fd);
+    unlink(socketPath.c_str());
+  }
+
+  q.close();
+  for (thread &th : workers) th.join();
+  for (pair<const string, SCPsolver*> &p : Instances) delete p.second;
+  return 0;
+}
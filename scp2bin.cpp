@@ -0,0 +1,38 @@
+#include "SCPv.hpp"
+#include <cstdio>
+#include <iostream>
+using namespace std;
+
+// OR-Library のテキスト形式のインスタンスをバイナリ形式に変換する
+//   % ./scp2bin scpnrg1.txt scpnrg1.bin
+// 変換したファイルは rnkc_main にそのまま渡せる
+int main(int argc, char** argv)
+{
+  if (argc < 3){
+    cout << "Usage: ./scp2bin input.txt output.bin" << endl;
+    return 0;
+  }
+
+  FILE *SourceFile = fopen(argv[1], "r");
+  if (SourceFile == NULL)
+  {
+    printf("Cannot open %s\n", argv[1]);
+    return 1;
+  }
+
+  try
+  {
+    SCPinstance inst(SourceFile);
+    inst.write_binary(argv[2]);
+    printf("%s: %d rows, %d columns, %ld entries\n",
+           argv[2], inst.numRows, inst.numColumns, inst.RowCovers.num_entries());
+  }
+  catch (DataException&)
+  {
+    printf("Failed to convert %s\n", argv[1]);
+    return 1;
+  }
+  fclose(SourceFile);
+
+  return 0;
+}